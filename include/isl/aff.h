@@ -22,6 +22,7 @@ __isl_give isl_aff *isl_aff_var_on_domain(__isl_take isl_local_space *ls,
 __isl_give isl_aff *isl_aff_nan_on_domain(__isl_take isl_local_space *ls);
 
 __isl_give isl_aff *isl_aff_copy(__isl_keep isl_aff *aff);
+__isl_give isl_aff *isl_aff_transfer(__isl_take isl_aff *aff, isl_ctx *ctx);
 __isl_null isl_aff *isl_aff_free(__isl_take isl_aff *aff);
 
 isl_ctx *isl_aff_get_ctx(__isl_keep isl_aff *aff);
@@ -200,6 +201,8 @@ __isl_give isl_pw_aff *isl_pw_aff_union_add(__isl_take isl_pw_aff *pwaff1,
 
 __isl_give isl_pw_aff *isl_pw_aff_copy(__isl_keep isl_pw_aff *pwaff);
 __isl_null isl_pw_aff *isl_pw_aff_free(__isl_take isl_pw_aff *pwaff);
+__isl_give isl_pw_aff *isl_pw_aff_transfer(__isl_take isl_pw_aff *pwaff,
+	isl_ctx *ctx);
 
 unsigned isl_pw_aff_dim(__isl_keep isl_pw_aff *pwaff, enum isl_dim_type type);
 isl_bool isl_pw_aff_involves_dims(__isl_keep isl_pw_aff *pwaff,
@@ -422,6 +425,8 @@ __isl_give isl_pw_multi_aff *isl_pw_multi_aff_copy(
 	__isl_keep isl_pw_multi_aff *pma);
 __isl_null isl_pw_multi_aff *isl_pw_multi_aff_free(
 	__isl_take isl_pw_multi_aff *pma);
+__isl_give isl_pw_multi_aff *isl_pw_multi_aff_transfer(
+	__isl_take isl_pw_multi_aff *pma, isl_ctx *ctx);
 
 unsigned isl_pw_multi_aff_dim(__isl_keep isl_pw_multi_aff *pma,
 	enum isl_dim_type type);
@@ -586,6 +591,8 @@ __isl_give isl_union_pw_multi_aff *isl_union_pw_multi_aff_copy(
 	__isl_keep isl_union_pw_multi_aff *upma);
 __isl_null isl_union_pw_multi_aff *isl_union_pw_multi_aff_free(
 	__isl_take isl_union_pw_multi_aff *upma);
+__isl_give isl_union_pw_multi_aff *isl_union_pw_multi_aff_transfer(
+	__isl_take isl_union_pw_multi_aff *upma, isl_ctx *ctx);
 
 __isl_give isl_union_pw_multi_aff *isl_union_set_identity_union_pw_multi_aff(
 	__isl_take isl_union_set *uset);
@@ -776,6 +783,8 @@ __isl_give isl_union_pw_aff *isl_union_pw_aff_copy(
 	__isl_keep isl_union_pw_aff *upa);
 __isl_null isl_union_pw_aff *isl_union_pw_aff_free(
 	__isl_take isl_union_pw_aff *upa);
+__isl_give isl_union_pw_aff *isl_union_pw_aff_transfer(
+	__isl_take isl_union_pw_aff *upa, isl_ctx *ctx);
 
 isl_ctx *isl_union_pw_aff_get_ctx(__isl_keep isl_union_pw_aff *upa);
 __isl_give isl_space *isl_union_pw_aff_get_space(
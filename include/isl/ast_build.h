@@ -115,6 +115,9 @@ __isl_give isl_ast_expr *isl_ast_build_call_from_multi_pw_aff(
 
 __isl_give isl_ast_node *isl_ast_build_node_from_schedule(
 	__isl_keep isl_ast_build *build, __isl_take isl_schedule *schedule);
+isl_stat isl_ast_build_foreach_node_from_schedule(
+	__isl_keep isl_ast_build *build, __isl_take isl_schedule *schedule,
+	isl_stat (*fn)(__isl_take isl_ast_node *node, void *user), void *user);
 __isl_export
 __isl_give isl_ast_node *isl_ast_build_node_from_schedule_map(
 	__isl_keep isl_ast_build *build, __isl_take isl_union_map *schedule);
@@ -70,6 +70,22 @@ extern "C" {
  */
 struct isl_stats {
 	long	gbr_solved_lps;
+	long	pivots;
+	long	tableaus;
+	long	max_tableau_rows;
+	long	max_tableau_cols;
+	long	emptiness_tests;
+	long	coalesce_pair_tests;
+	long	gist_calls;
+	long	lexopt_splits;
+	long	sample_cache_hits;
+	long	sample_cache_misses;
+	long	coefficients_cache_hits;
+	long	coefficients_cache_misses;
+	long	flow_lexmax_cache_hits;
+	long	flow_lexmax_cache_misses;
+	long	ast_expr_cache_hits;
+	long	ast_expr_cache_misses;
 };
 enum isl_error {
 	isl_error_none = 0,
@@ -171,6 +187,9 @@ void isl_ctx_set_max_operations(isl_ctx *ctx, unsigned long max_operations);
 unsigned long isl_ctx_get_max_operations(isl_ctx *ctx);
 void isl_ctx_reset_operations(isl_ctx *ctx);
 
+const struct isl_stats *isl_ctx_get_stats(isl_ctx *ctx);
+void isl_ctx_reset_stats(isl_ctx *ctx);
+
 #define ISL_ARG_CTX_DECL(prefix,st,args)				\
 st *isl_ctx_peek_ ## prefix(isl_ctx *ctx);
 
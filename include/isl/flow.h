@@ -105,6 +105,10 @@ __isl_give char *isl_union_access_info_to_str(
 __isl_export
 __isl_give isl_union_flow *isl_union_access_info_compute_flow(
 	__isl_take isl_union_access_info *access);
+__isl_give isl_union_flow *isl_union_access_info_update_flow(
+	__isl_take isl_union_access_info *access,
+	__isl_take isl_union_access_info *prev_access,
+	__isl_take isl_union_flow *prev_flow);
 
 isl_ctx *isl_union_flow_get_ctx(__isl_keep isl_union_flow *flow);
 __isl_give isl_union_flow *isl_union_flow_copy(
@@ -21,6 +21,7 @@ uint32_t isl_id_get_hash(__isl_keep isl_id *id);
 __isl_give isl_id *isl_id_alloc(isl_ctx *ctx,
 	__isl_keep const char *name, void *user);
 __isl_give isl_id *isl_id_copy(isl_id *id);
+__isl_give isl_id *isl_id_transfer(__isl_take isl_id *id, isl_ctx *ctx);
 __isl_null isl_id *isl_id_free(__isl_take isl_id *id);
 
 void *isl_id_get_user(__isl_keep isl_id *id);
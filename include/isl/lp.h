@@ -13,6 +13,7 @@
 #include <isl/aff.h>
 #include <isl/val.h>
 #include <isl/set_type.h>
+#include <isl/constraint.h>
 
 enum isl_lp_result {
 	isl_lp_error = -1,
@@ -21,6 +22,9 @@ enum isl_lp_result {
 	isl_lp_empty
 };
 
+struct isl_lp_session;
+typedef struct isl_lp_session isl_lp_session;
+
 #if defined(__cplusplus)
 extern "C" {
 #endif
@@ -30,6 +34,20 @@ __isl_give isl_val *isl_basic_set_min_lp_val(__isl_keep isl_basic_set *bset,
 __isl_give isl_val *isl_basic_set_max_lp_val(__isl_keep isl_basic_set *bset,
 	__isl_keep isl_aff *obj);
 
+__isl_give isl_lp_session *isl_lp_session_alloc(
+	__isl_take isl_basic_set *bset);
+__isl_null isl_lp_session *isl_lp_session_free(
+	__isl_take isl_lp_session *lp);
+isl_ctx *isl_lp_session_get_ctx(__isl_keep isl_lp_session *lp);
+__isl_give isl_val *isl_lp_session_min_val(__isl_keep isl_lp_session *lp,
+	__isl_keep isl_aff *obj);
+__isl_give isl_val *isl_lp_session_max_val(__isl_keep isl_lp_session *lp,
+	__isl_keep isl_aff *obj);
+isl_stat isl_lp_session_add_constraint(__isl_keep isl_lp_session *lp,
+	__isl_take isl_constraint *constraint);
+isl_stat isl_lp_session_snapshot(__isl_keep isl_lp_session *lp);
+isl_stat isl_lp_session_rollback(__isl_keep isl_lp_session *lp);
+
 #if defined(__cplusplus)
 }
 #endif
@@ -32,6 +32,7 @@ struct isl_mat *isl_mat_extend(struct isl_mat *mat,
 	unsigned n_row, unsigned n_col);
 struct isl_mat *isl_mat_identity(struct isl_ctx *ctx, unsigned n_row);
 __isl_give isl_mat *isl_mat_copy(__isl_keep isl_mat *mat);
+__isl_give isl_mat *isl_mat_transfer(__isl_take isl_mat *mat, isl_ctx *ctx);
 struct isl_mat *isl_mat_cow(struct isl_mat *mat);
 __isl_null isl_mat *isl_mat_free(__isl_take isl_mat *mat);
 
@@ -46,6 +46,12 @@ int isl_options_get_pip_symmetry(isl_ctx *ctx);
 isl_stat isl_options_set_coalesce_bounded_wrapping(isl_ctx *ctx, int val);
 int isl_options_get_coalesce_bounded_wrapping(isl_ctx *ctx);
 
+isl_stat isl_options_set_sample_cache_size(isl_ctx *ctx, int val);
+int isl_options_get_sample_cache_size(isl_ctx *ctx);
+
+isl_stat isl_options_set_coefficients_cache_size(isl_ctx *ctx, int val);
+int isl_options_get_coefficients_cache_size(isl_ctx *ctx);
+
 #if defined(__cplusplus)
 }
 #endif
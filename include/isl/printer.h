@@ -77,6 +77,9 @@ __isl_give isl_printer *isl_printer_yaml_next(__isl_take isl_printer *p);
 
 __isl_give isl_printer *isl_printer_flush(__isl_take isl_printer *p);
 
+__isl_give isl_printer *isl_printer_print_stats(__isl_take isl_printer *p,
+	const struct isl_stats *stats);
+
 #if defined(__cplusplus)
 }
 #endif
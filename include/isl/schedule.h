@@ -47,6 +47,14 @@ int isl_options_get_schedule_serialize_sccs(isl_ctx *ctx);
 isl_stat isl_options_set_schedule_whole_component(isl_ctx *ctx, int val);
 int isl_options_get_schedule_whole_component(isl_ctx *ctx);
 
+isl_stat isl_options_set_schedule_max_operations(isl_ctx *ctx, int val);
+int isl_options_get_schedule_max_operations(isl_ctx *ctx);
+
+isl_stat isl_options_set_schedule_trace(isl_ctx *ctx, int val);
+int isl_options_get_schedule_trace(isl_ctx *ctx);
+isl_stat isl_ctx_set_schedule_trace_callback(isl_ctx *ctx,
+	void (*fn)(const char *record, void *user), void *user);
+
 __isl_give isl_schedule_constraints *isl_schedule_constraints_copy(
 	__isl_keep isl_schedule_constraints *sc);
 __isl_give isl_schedule_constraints *isl_schedule_constraints_on_domain(
@@ -112,6 +120,10 @@ __isl_give char *isl_schedule_constraints_to_str(
 
 __isl_give isl_schedule *isl_schedule_constraints_compute_schedule(
 	__isl_take isl_schedule_constraints *sc);
+__isl_give isl_schedule *isl_schedule_constraints_update_schedule(
+	__isl_take isl_schedule_constraints *sc,
+	__isl_take isl_schedule_constraints *prev_sc,
+	__isl_take isl_schedule *prev);
 
 __isl_give isl_schedule *isl_union_set_compute_schedule(
 	__isl_take isl_union_set *domain,
@@ -123,6 +135,8 @@ __isl_give isl_schedule *isl_schedule_from_domain(
 	__isl_take isl_union_set *domain);
 __isl_give isl_schedule *isl_schedule_copy(__isl_keep isl_schedule *sched);
 __isl_null isl_schedule *isl_schedule_free(__isl_take isl_schedule *sched);
+__isl_give isl_schedule *isl_schedule_transfer(
+	__isl_take isl_schedule *schedule, isl_ctx *ctx);
 __isl_export
 __isl_give isl_union_map *isl_schedule_get_map(__isl_keep isl_schedule *sched);
 
@@ -38,6 +38,8 @@ __isl_give isl_space *isl_space_set_alloc(isl_ctx *ctx,
 			unsigned nparam, unsigned dim);
 __isl_give isl_space *isl_space_params_alloc(isl_ctx *ctx, unsigned nparam);
 __isl_give isl_space *isl_space_copy(__isl_keep isl_space *dim);
+__isl_give isl_space *isl_space_transfer(__isl_take isl_space *space,
+	isl_ctx *ctx);
 __isl_null isl_space *isl_space_free(__isl_take isl_space *space);
 
 isl_bool isl_space_is_params(__isl_keep isl_space *space);
@@ -25,6 +25,7 @@ typedef struct isl_vec isl_vec;
 
 __isl_give isl_vec *isl_vec_alloc(isl_ctx *ctx, unsigned size);
 __isl_give isl_vec *isl_vec_copy(__isl_keep isl_vec *vec);
+__isl_give isl_vec *isl_vec_transfer(__isl_take isl_vec *vec, isl_ctx *ctx);
 __isl_null isl_vec *isl_vec_free(__isl_take isl_vec *vec);
 
 isl_ctx *isl_vec_get_ctx(__isl_keep isl_vec *vec);
@@ -243,6 +243,27 @@ __isl_give isl_aff *isl_aff_dup(__isl_keep isl_aff *aff)
 				 isl_vec_copy(aff->v));
 }
 
+/* Return a copy of "aff" in "ctx".
+ */
+__isl_give isl_aff *isl_aff_transfer(__isl_take isl_aff *aff, isl_ctx *ctx)
+{
+	isl_local_space *ls;
+	isl_vec *v;
+
+	if (!aff || !ctx)
+		goto error;
+	if (isl_aff_get_ctx(aff) == ctx)
+		return aff;
+
+	ls = isl_local_space_transfer(isl_local_space_copy(aff->ls), ctx);
+	v = isl_vec_transfer(isl_vec_copy(aff->v), ctx);
+	isl_aff_free(aff);
+	return isl_aff_alloc_vec(ls, v);
+error:
+	isl_aff_free(aff);
+	return NULL;
+}
+
 __isl_give isl_aff *isl_aff_cow(__isl_take isl_aff *aff)
 {
 	if (!aff)
@@ -17,6 +17,7 @@
 #include <isl/union_set.h>
 #include <isl/union_map.h>
 #include <isl_ast_build_private.h>
+#include <isl_ast_build_expr.h>
 #include <isl_ast_private.h>
 #include <isl_config.h>
 
@@ -76,7 +77,8 @@ static __isl_give isl_ast_build *isl_ast_build_init_derived(
 
 	if (!build->iterators || !build->domain || !build->generated ||
 	    !build->pending || !build->values || !build->internal2input ||
-	    !build->strides || !build->offsets || !build->options)
+	    !build->strides || !build->offsets || !build->options ||
+	    !build->expr_cache)
 		return isl_ast_build_free(build);
 
 	return build;
@@ -131,6 +133,7 @@ __isl_give isl_ast_build *isl_ast_build_from_context(__isl_take isl_set *set)
 	build->generated = isl_set_copy(build->domain);
 	build->pending = isl_set_universe(isl_set_get_space(build->domain));
 	build->options = isl_union_map_empty(isl_space_params_alloc(ctx, 0));
+	build->expr_cache = isl_ast_expr_cache_alloc(ctx);
 	n = isl_set_dim(set, isl_dim_set);
 	build->depth = n;
 	build->iterators = isl_id_list_alloc(ctx, n);
@@ -215,6 +218,7 @@ __isl_give isl_ast_build *isl_ast_build_dup(__isl_keep isl_ast_build *build)
 	dup->create_leaf = build->create_leaf;
 	dup->create_leaf_user = build->create_leaf_user;
 	dup->node = isl_schedule_node_copy(build->node);
+	dup->expr_cache = isl_ast_expr_cache_copy(build->expr_cache);
 	if (build->loop_type) {
 		int i;
 
@@ -230,6 +234,7 @@ __isl_give isl_ast_build *isl_ast_build_dup(__isl_keep isl_ast_build *build)
 	if (!dup->iterators || !dup->domain || !dup->generated ||
 	    !dup->pending || !dup->values ||
 	    !dup->strides || !dup->offsets || !dup->options ||
+	    !dup->expr_cache ||
 	    (build->internal2input && !dup->internal2input) ||
 	    (build->executed && !dup->executed) ||
 	    (build->value && !dup->value) ||
@@ -316,6 +321,7 @@ __isl_null isl_ast_build *isl_ast_build_free(
 	isl_schedule_node_free(build->node);
 	free(build->loop_type);
 	isl_set_free(build->isolated);
+	isl_ast_expr_cache_free(build->expr_cache);
 
 	free(build);
 
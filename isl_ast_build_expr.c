@@ -12,6 +12,7 @@
 
 #include <isl/constraint.h>
 #include <isl/ilp.h>
+#include <isl_ctx_private.h>
 #include <isl_ast_build_expr.h>
 #include <isl_ast_private.h>
 #include <isl_ast_build_private.h>
@@ -1075,7 +1076,7 @@ error:
  * Finally, if the affine expression has a non-trivial denominator,
  * we divide the resulting isl_ast_expr by this denominator.
  */
-__isl_give isl_ast_expr *isl_ast_expr_from_aff(__isl_take isl_aff *aff,
+static __isl_give isl_ast_expr *compute_expr_from_aff(__isl_take isl_aff *aff,
 	__isl_keep isl_ast_build *build)
 {
 	int i, j;
@@ -1125,6 +1126,227 @@ __isl_give isl_ast_expr *isl_ast_expr_from_aff(__isl_take isl_aff *aff,
 	return expr;
 }
 
+/* The maximal number of elements in an isl_ast_expr_cache.
+ * If this number is reached, then the cache is cleared.
+ */
+#define ISL_AST_EXPR_CACHE_MAX_SIZE	1024
+
+/* A cache of AST expressions constructed by isl_ast_expr_from_aff.
+ *
+ * "table" contains elements of type struct isl_ast_expr_cache_entry.
+ */
+struct isl_ast_expr_cache {
+	int ref;
+	isl_ctx *ctx;
+	struct isl_hash_table *table;
+};
+
+/* An element of an isl_ast_expr_cache.
+ *
+ * "expr" is the result of calling isl_ast_expr_from_aff on "aff"
+ * with respect to an isl_ast_build with domain "domain" and
+ * iterators "iterators", while the ast_build_prefer_pdiv option
+ * was set to "prefer_pdiv".
+ */
+struct isl_ast_expr_cache_entry {
+	isl_aff *aff;
+	isl_set *domain;
+	isl_id_list *iterators;
+	int prefer_pdiv;
+
+	isl_ast_expr *expr;
+};
+
+/* Allocate an empty isl_ast_expr_cache.
+ */
+struct isl_ast_expr_cache *isl_ast_expr_cache_alloc(isl_ctx *ctx)
+{
+	struct isl_ast_expr_cache *cache;
+
+	cache = isl_calloc_type(ctx, struct isl_ast_expr_cache);
+	if (!cache)
+		return NULL;
+
+	cache->ref = 1;
+	cache->ctx = ctx;
+	isl_ctx_ref(ctx);
+	cache->table = isl_hash_table_alloc(ctx, 0);
+	if (!cache->table)
+		return isl_ast_expr_cache_free(cache);
+
+	return cache;
+}
+
+struct isl_ast_expr_cache *isl_ast_expr_cache_copy(
+	struct isl_ast_expr_cache *cache)
+{
+	if (!cache)
+		return NULL;
+
+	cache->ref++;
+	return cache;
+}
+
+static isl_stat free_expr_cache_entry(void **entry, void *user)
+{
+	struct isl_ast_expr_cache_entry *cache_entry = *entry;
+
+	isl_aff_free(cache_entry->aff);
+	isl_set_free(cache_entry->domain);
+	isl_id_list_free(cache_entry->iterators);
+	isl_ast_expr_free(cache_entry->expr);
+	free(cache_entry);
+
+	return isl_stat_ok;
+}
+
+/* Remove all elements from "cache".
+ */
+static isl_stat isl_ast_expr_cache_clear(struct isl_ast_expr_cache *cache)
+{
+	isl_hash_table_foreach(cache->ctx, cache->table,
+				&free_expr_cache_entry, NULL);
+	isl_hash_table_free(cache->ctx, cache->table);
+	cache->table = isl_hash_table_alloc(cache->ctx, 0);
+	if (!cache->table)
+		return isl_stat_error;
+
+	return isl_stat_ok;
+}
+
+struct isl_ast_expr_cache *isl_ast_expr_cache_free(
+	struct isl_ast_expr_cache *cache)
+{
+	if (!cache)
+		return NULL;
+
+	if (--cache->ref > 0)
+		return NULL;
+
+	if (cache->table)
+		isl_hash_table_foreach(cache->ctx, cache->table,
+					&free_expr_cache_entry, NULL);
+	isl_hash_table_free(cache->ctx, cache->table);
+	isl_ctx_deref(cache->ctx);
+	free(cache);
+
+	return NULL;
+}
+
+/* Does the cache element "entry" correspond to the input "val",
+ * given in the form of an isl_ast_expr_cache_entry without result?
+ *
+ * Only the iterators that may appear in the affine expression,
+ * i.e., those of its input dimensions, need to be the same.
+ * The domains are compared last since this is the most expensive test.
+ */
+static int has_expr_input(const void *entry, const void *val)
+{
+	const struct isl_ast_expr_cache_entry *cache_entry = entry;
+	const struct isl_ast_expr_cache_entry *input = val;
+	int i, n;
+	isl_bool equal;
+
+	if (cache_entry->prefer_pdiv != input->prefer_pdiv)
+		return 0;
+	equal = isl_aff_plain_is_equal(cache_entry->aff, input->aff);
+	if (equal < 0 || !equal)
+		return 0;
+	n = isl_aff_dim(input->aff, isl_dim_in);
+	if (isl_id_list_n_id(cache_entry->iterators) < n ||
+	    isl_id_list_n_id(input->iterators) < n)
+		return 0;
+	for (i = 0; i < n; ++i) {
+		isl_id *id1, *id2;
+
+		id1 = isl_id_list_get_id(cache_entry->iterators, i);
+		id2 = isl_id_list_get_id(input->iterators, i);
+		isl_id_free(id1);
+		isl_id_free(id2);
+		if (id1 != id2)
+			return 0;
+	}
+	equal = isl_set_plain_is_equal(cache_entry->domain, input->domain);
+	return equal == isl_bool_true;
+}
+
+/* Construct an isl_ast_expr that evaluates the affine expression "aff",
+ * The result is simplified in terms of build->domain.
+ *
+ * The same affine expressions are typically converted many times
+ * during AST generation in the same context, e.g., when they appear
+ * in the bounds or guards of several statements.
+ * Reuse the result of a previous conversion from build->expr_cache
+ * if there is one.  Otherwise, construct the AST expression
+ * and store it in the cache.
+ * The cache is cleared when it becomes too large.
+ */
+__isl_give isl_ast_expr *isl_ast_expr_from_aff(__isl_take isl_aff *aff,
+	__isl_keep isl_ast_build *build)
+{
+	isl_ctx *ctx;
+	uint32_t hash;
+	struct isl_ast_expr_cache *cache;
+	struct isl_hash_table_entry *entry;
+	struct isl_ast_expr_cache_entry input;
+	struct isl_ast_expr_cache_entry *cache_entry;
+	isl_ast_expr *expr;
+
+	if (!aff || !build)
+		goto error;
+	cache = build->expr_cache;
+	if (!cache || !cache->table)
+		return compute_expr_from_aff(aff, build);
+
+	ctx = isl_aff_get_ctx(aff);
+	input.aff = aff;
+	input.domain = build->domain;
+	input.iterators = build->iterators;
+	input.prefer_pdiv = isl_options_get_ast_build_prefer_pdiv(ctx);
+	hash = isl_hash_init();
+	isl_hash_hash(hash, isl_aff_get_hash(aff));
+	isl_hash_byte(hash, input.prefer_pdiv);
+	entry = isl_hash_table_find(ctx, cache->table, hash,
+					&has_expr_input, &input, 0);
+	if (entry) {
+		ctx->stats->ast_expr_cache_hits++;
+		cache_entry = entry->data;
+		isl_aff_free(aff);
+		return isl_ast_expr_copy(cache_entry->expr);
+	}
+	ctx->stats->ast_expr_cache_misses++;
+
+	expr = compute_expr_from_aff(isl_aff_copy(aff), build);
+	if (!expr)
+		goto error;
+
+	if (cache->table->n >= ISL_AST_EXPR_CACHE_MAX_SIZE &&
+	    isl_ast_expr_cache_clear(cache) < 0)
+		goto error_expr;
+	entry = isl_hash_table_find(ctx, cache->table, hash,
+					&has_expr_input, &input, 1);
+	if (!entry)
+		goto error_expr;
+	cache_entry = isl_calloc_type(ctx, struct isl_ast_expr_cache_entry);
+	if (!cache_entry) {
+		isl_hash_table_remove(ctx, cache->table, entry);
+		goto error_expr;
+	}
+	cache_entry->aff = aff;
+	cache_entry->domain = isl_set_copy(build->domain);
+	cache_entry->iterators = isl_id_list_copy(build->iterators);
+	cache_entry->prefer_pdiv = input.prefer_pdiv;
+	cache_entry->expr = isl_ast_expr_copy(expr);
+	entry->data = cache_entry;
+
+	return expr;
+error_expr:
+	isl_ast_expr_free(expr);
+error:
+	isl_aff_free(aff);
+	return NULL;
+}
+
 /* Add terms to "expr" for each variable in "aff" with a coefficient
  * with sign equal to "sign".
  * The result is simplified in terms of data->build->domain.
@@ -4,6 +4,14 @@
 #include <isl/ast.h>
 #include <isl/ast_build.h>
 
+struct isl_ast_expr_cache;
+
+struct isl_ast_expr_cache *isl_ast_expr_cache_alloc(isl_ctx *ctx);
+struct isl_ast_expr_cache *isl_ast_expr_cache_copy(
+	struct isl_ast_expr_cache *cache);
+struct isl_ast_expr_cache *isl_ast_expr_cache_free(
+	struct isl_ast_expr_cache *cache);
+
 __isl_give isl_ast_expr *isl_ast_build_expr_from_basic_set(
 	 __isl_keep isl_ast_build *build, __isl_take isl_basic_set *bset);
 __isl_give isl_ast_expr *isl_ast_build_expr_from_set_internal(
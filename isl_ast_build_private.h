@@ -141,6 +141,12 @@
  * "isolated" is the piece of the schedule domain isolated by the isolate
  * option on the current band.  This set may be NULL if we have not checked
  * for the isolate option yet.
+ *
+ * "expr_cache" caches the AST expressions constructed for affine
+ * expressions by isl_ast_expr_from_aff.  It is shared by all
+ * isl_ast_build objects derived from the same original isl_ast_build.
+ * Since the constructed AST expressions depend on "domain" and
+ * "iterators", these are part of the key of each cached element.
  */
 struct isl_ast_build {
 	int ref;
@@ -197,6 +203,8 @@ struct isl_ast_build {
 	int n;
 	enum isl_ast_loop_type *loop_type;
 	isl_set *isolated;
+
+	struct isl_ast_expr_cache *expr_cache;
 };
 
 __isl_give isl_ast_build *isl_ast_build_clear_local_info(
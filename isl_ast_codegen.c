@@ -11,6 +11,7 @@
  */
 
 #include <limits.h>
+#include <isl_union_map_private.h>
 #include <isl/aff.h>
 #include <isl/constraint.h>
 #include <isl/set.h>
@@ -5532,6 +5533,118 @@ static __isl_give isl_ast_graft_list *build_ast_from_schedule_node(
 	__isl_take isl_ast_build *build, __isl_take isl_schedule_node *node,
 	__isl_take isl_union_map *executed);
 
+/* Return the space of the domain of "executed" if all maps in "executed"
+ * share the same domain space.  Otherwise, return NULL.
+ * The parameters are removed from the result such that
+ * it can be combined with the space of a filter.
+ */
+static __isl_give isl_space *shared_domain_space(
+	__isl_keep isl_union_map *executed)
+{
+	isl_union_set *domain;
+	isl_space *space = NULL;
+
+	domain = isl_union_map_domain(isl_union_map_copy(executed));
+	domain = isl_union_set_universe(domain);
+	if (isl_union_set_n_set(domain) == 1) {
+		isl_set *set = isl_set_from_union_set(domain);
+		space = isl_set_get_space(set);
+		isl_set_free(set);
+		space = isl_space_drop_dims(space, isl_dim_param,
+				0, isl_space_dim(space, isl_dim_param));
+	} else {
+		isl_union_set_free(domain);
+	}
+
+	return space;
+}
+
+/* Generate an AST that visits the elements in the domain of "executed"
+ * in the relative order specified by the filter node "node",
+ * which is a child of a sequence (or set) node, and its descendants,
+ * given that all maps in "executed" have a domain in the space "domain".
+ *
+ * The result is the same as that of build_ast_from_filter, but
+ * the intersection with the filter is computed by looking up
+ * the maps in "executed" that match the spaces of the filter
+ * since a filter of a child of a sequence typically only refers
+ * to a small number of the statements in "executed".
+ * If the filter selects (part of) every map in "executed" or
+ * if the filter introduces new parameters, then
+ * build_ast_from_filter is called instead.
+ * Otherwise, the intersection is certainly different from "executed"
+ * such that build_ast_from_filter would continue with the intersection
+ * (or return an empty list if the intersection is empty).
+ */
+static __isl_give isl_ast_graft_list *build_ast_from_sequence_filter(
+	__isl_take isl_ast_build *build, __isl_take isl_schedule_node *node,
+	__isl_take isl_union_map *executed, __isl_keep isl_space *domain)
+{
+	isl_ctx *ctx;
+	isl_union_set *filter;
+	isl_union_map *filtered;
+	int n, n_filtered;
+	unsigned n1, n2;
+
+	filter = isl_schedule_node_filter_get_filter(node);
+	filter = isl_union_set_align_params(filter,
+				isl_union_map_get_space(executed));
+	n1 = isl_union_map_dim(executed, isl_dim_param);
+	n2 = isl_union_set_dim(filter, isl_dim_param);
+	if (!filter || n2 > n1) {
+		isl_union_set_free(filter);
+		return build_ast_from_filter(build, node, executed);
+	}
+
+	n = isl_union_map_n_map(executed);
+	filtered = isl_union_map_intersect_range_domain_space(
+			isl_union_map_copy(executed), filter,
+			isl_space_copy(domain));
+	n_filtered = isl_union_map_n_map(filtered);
+	if (!filtered || n_filtered == n) {
+		isl_union_map_free(filtered);
+		return build_ast_from_filter(build, node, executed);
+	}
+	isl_union_map_free(executed);
+	if (n_filtered > 0)
+		return build_ast_from_child(build, node, filtered);
+
+	ctx = isl_ast_build_get_ctx(build);
+	isl_ast_build_free(build);
+	isl_schedule_node_free(node);
+	isl_union_map_free(filtered);
+	return isl_ast_graft_list_alloc(ctx, 0);
+}
+
+/* Generate an AST that visits the elements in the domain of "executed"
+ * in the relative order specified by child "pos" of the sequence (or set)
+ * node "node" and its descendants.
+ *
+ * The relation "executed" maps the outer generated loop iterators
+ * to the domain elements executed by those iterations.
+ *
+ * The children of a sequence (or set) node are filter nodes.
+ * If all maps in "executed" have the same domain space "domain", then
+ * they are handled by build_ast_from_sequence_filter, which
+ * avoids considering all maps in "executed" for each child.
+ * "domain" is NULL if the maps do not have the same domain space.
+ */
+static __isl_give isl_ast_graft_list *build_ast_from_sequence_child(
+	__isl_keep isl_ast_build *build, __isl_keep isl_schedule_node *node,
+	int pos, __isl_keep isl_union_map *executed,
+	__isl_keep isl_space *domain)
+{
+	isl_schedule_node *child;
+
+	child = isl_schedule_node_get_child(node, pos);
+	if (domain &&
+	    isl_schedule_node_get_type(child) == isl_schedule_node_filter)
+		return build_ast_from_sequence_filter(isl_ast_build_copy(build),
+				child, isl_union_map_copy(executed), domain);
+	return build_ast_from_schedule_node(isl_ast_build_copy(build), child,
+				isl_union_map_copy(executed));
+}
+
 /* Generate an AST that visits the elements in the domain of "executed"
  * in the relative order specified by the sequence (or set) node "node" and
  * its descendants.
@@ -5548,21 +5661,22 @@ static __isl_give isl_ast_graft_list *build_ast_from_sequence(
 {
 	int i, n;
 	isl_ctx *ctx;
+	isl_space *domain;
 	isl_ast_graft_list *list;
 
 	ctx = isl_ast_build_get_ctx(build);
 	list = isl_ast_graft_list_alloc(ctx, 0);
 
+	domain = shared_domain_space(executed);
 	n = isl_schedule_node_n_children(node);
 	for (i = 0; i < n; ++i) {
-		isl_schedule_node *child;
 		isl_ast_graft_list *list_i;
 
-		child = isl_schedule_node_get_child(node, i);
-		list_i = build_ast_from_schedule_node(isl_ast_build_copy(build),
-					child, isl_union_map_copy(executed));
+		list_i = build_ast_from_sequence_child(build, node, i,
+							executed, domain);
 		list = isl_ast_graft_list_concat(list, list_i);
 	}
+	isl_space_free(domain);
 	isl_ast_build_free(build);
 	isl_schedule_node_free(node);
 	isl_union_map_free(executed);
@@ -5650,8 +5764,11 @@ static __isl_give isl_ast_graft_list *build_ast_from_child(
 	return build_ast_from_schedule_node(build, node, executed);
 }
 
-/* Generate an AST that visits the elements in the domain of the domain
- * node "node" in the relative order specified by its descendants.
+/* Prepare for generating an AST that visits the elements in the domain
+ * of the domain node "node" in the relative order specified
+ * by its descendants.
+ * Return the modified build and store the initial inverse schedule
+ * in "executed".
  *
  * An initial inverse schedule is created that maps a zero-dimensional
  * schedule space to the node domain.
@@ -5665,30 +5782,30 @@ static __isl_give isl_ast_graft_list *build_ast_from_child(
  * more disjuncts than necessary.  We therefore approximate
  * the constraints on the parameters by a single disjunct set.
  */
-static __isl_give isl_ast_node *build_ast_from_domain(
-	__isl_take isl_ast_build *build, __isl_take isl_schedule_node *node)
+static __isl_give isl_ast_build *build_from_domain(
+	__isl_take isl_ast_build *build, __isl_keep isl_schedule_node *node,
+	__isl_give isl_union_map **executed)
 {
 	isl_ctx *ctx;
 	isl_union_set *domain, *schedule_domain;
-	isl_union_map *executed;
 	isl_space *space;
 	isl_set *set;
-	isl_ast_graft_list *list;
-	isl_ast_node *ast;
 	int is_params;
 
+	*executed = NULL;
 	if (!build)
-		goto error;
+		return NULL;
 
 	ctx = isl_ast_build_get_ctx(build);
 	space = isl_ast_build_get_space(build, 1);
 	is_params = isl_space_is_params(space);
 	isl_space_free(space);
 	if (is_params < 0)
-		goto error;
+		return isl_ast_build_free(build);
 	if (!is_params)
 		isl_die(ctx, isl_error_unsupported,
-			"expecting parametric initial context", goto error);
+			"expecting parametric initial context",
+			return isl_ast_build_free(build));
 
 	domain = isl_schedule_node_domain_get_domain(node);
 	domain = isl_union_set_coalesce(domain);
@@ -5701,18 +5818,96 @@ static __isl_give isl_ast_node *build_ast_from_domain(
 	set = isl_set_from_basic_set(isl_set_simple_hull(set));
 	schedule_domain = isl_union_set_from_set(set);
 
-	executed = isl_union_map_from_domain_and_range(schedule_domain, domain);
+	*executed = isl_union_map_from_domain_and_range(schedule_domain,
+							domain);
+	if (!*executed)
+		return isl_ast_build_free(build);
+
+	return build;
+}
+
+/* Generate an AST that visits the elements in the domain of the domain
+ * node "node" in the relative order specified by its descendants.
+ */
+static __isl_give isl_ast_node *build_ast_from_domain(
+	__isl_take isl_ast_build *build, __isl_take isl_schedule_node *node)
+{
+	isl_union_map *executed;
+	isl_ast_graft_list *list;
+	isl_ast_node *ast;
+
+	build = build_from_domain(build, node, &executed);
+	if (!build)
+		goto error;
+
 	list = build_ast_from_child(isl_ast_build_copy(build), node, executed);
 	ast = isl_ast_node_from_graft_list(list, build);
 	isl_ast_build_free(build);
 
 	return ast;
 error:
+	isl_union_map_free(executed);
 	isl_schedule_node_free(node);
-	isl_ast_build_free(build);
 	return NULL;
 }
 
+/* Generate an AST that visits the elements in the domain of the domain
+ * node "node" in the relative order specified by its descendants and
+ * call "fn" on each of the top-level nodes of this AST as soon as
+ * it has been completed.
+ *
+ * If the child of "node" is a sequence (or set) node, then
+ * the AST is generated for one child of this node at a time and
+ * the resulting grafts are added to an isl_ast_graft_stream,
+ * which passes the nodes on to "fn" as soon as they can
+ * no longer be merged with the nodes generated for later children.
+ * Otherwise, the entire AST is generated before it is passed to "fn".
+ */
+static isl_stat foreach_node_from_domain(__isl_take isl_ast_build *build,
+	__isl_take isl_schedule_node *node,
+	isl_stat (*fn)(__isl_take isl_ast_node *node, void *user), void *user)
+{
+	int i, n;
+	isl_stat r;
+	isl_space *domain;
+	isl_union_map *executed;
+	isl_ast_graft_list *list;
+	struct isl_ast_graft_stream *stream;
+	enum isl_schedule_node_type type;
+
+	build = build_from_domain(build, node, &executed);
+	stream = isl_ast_graft_stream_alloc(build, fn, user);
+	node = isl_schedule_node_child(node, 0);
+	type = isl_schedule_node_get_type(node);
+	if (!stream || type == isl_schedule_node_error) {
+		r = isl_stat_error;
+	} else if (type == isl_schedule_node_sequence ||
+		    type == isl_schedule_node_set) {
+		domain = shared_domain_space(executed);
+		n = isl_schedule_node_n_children(node);
+		r = n < 0 ? isl_stat_error : isl_stat_ok;
+		for (i = 0; r >= 0 && i < n; ++i) {
+			list = build_ast_from_sequence_child(build, node, i,
+							executed, domain);
+			r = isl_ast_graft_stream_add(stream, list);
+		}
+		isl_space_free(domain);
+	} else {
+		list = build_ast_from_schedule_node(isl_ast_build_copy(build),
+				isl_schedule_node_copy(node),
+				isl_union_map_copy(executed));
+		r = isl_ast_graft_stream_add(stream, list);
+	}
+	if (r >= 0)
+		r = isl_ast_graft_stream_flush(stream);
+
+	isl_ast_graft_stream_free(stream);
+	isl_union_map_free(executed);
+	isl_schedule_node_free(node);
+	isl_ast_build_free(build);
+	return r;
+}
+
 /* Generate an AST that visits the elements in the domain of "schedule"
  * in the relative order specified by the schedule tree.
  *
@@ -5748,3 +5943,50 @@ error:
 	isl_schedule_free(schedule);
 	return NULL;
 }
+
+/* Generate an AST that visits the elements in the domain of "schedule"
+ * in the relative order specified by the schedule tree and
+ * call "fn" on each of its top-level nodes.
+ * That is, if isl_ast_build_node_from_schedule would return a block node,
+ * then "fn" is called on each of the children of this block node.
+ * Otherwise, it is called on the single node that would be returned.
+ *
+ * Each top-level node is passed to "fn" as soon as it has been completed
+ * (as opposed to after the entire AST has been generated), such that
+ * it can be printed and freed before the rest of the AST is generated.
+ * In particular, if the child of the root domain node is a sequence
+ * (or set) node, then the nodes are generated one child of this node
+ * at a time.
+ *
+ * "build" is an isl_ast_build that has been created using
+ * isl_ast_build_alloc or isl_ast_build_from_context based
+ * on a parametric set.
+ */
+isl_stat isl_ast_build_foreach_node_from_schedule(
+	__isl_keep isl_ast_build *build, __isl_take isl_schedule *schedule,
+	isl_stat (*fn)(__isl_take isl_ast_node *node, void *user), void *user)
+{
+	isl_ctx *ctx;
+	isl_schedule_node *node;
+
+	if (!build || !schedule)
+		goto error;
+
+	ctx = isl_ast_build_get_ctx(build);
+
+	node = isl_schedule_get_root(schedule);
+	isl_schedule_free(schedule);
+
+	if (isl_schedule_node_get_type(node) != isl_schedule_node_domain) {
+		isl_schedule_node_free(node);
+		isl_die(ctx, isl_error_unsupported,
+			"expecting root domain node", return isl_stat_error);
+	}
+
+	build = isl_ast_build_copy(build);
+	build = isl_ast_build_set_single_valued(build, 0);
+	return foreach_node_from_domain(build, node, fn, user);
+error:
+	isl_schedule_free(schedule);
+	return isl_stat_error;
+}
@@ -521,12 +521,93 @@ static int clear_if_nodes(struct isl_if_node *if_node, int first, int n)
 	return first;
 }
 
-/* For each graft in "list",
- * insert an if node around graft->node testing the condition encoded
- * in graft->guard, assuming graft->guard involves any conditions.
+/* Internal data structure for insert_pending_guard.
+ *
+ * "build" is the build in which the if nodes are constructed.
+ * "allow_else" is set if else branches may be constructed.
+ * "if_node" is an array of size "size" containing the "n_if" if nodes
+ * that can be extended without changing the order of the grafts.
+ * "res" collects the resulting grafts.
+ * The if nodes all appear in the last element of "res".
+ */
+struct isl_pending_guard_data {
+	isl_ast_build *build;
+	int allow_else;
+
+	int n_if;
+	int size;
+	struct isl_if_node *if_node;
+
+	isl_ast_graft_list *res;
+};
+
+/* Initialize "data" for inserting if nodes in a sequence of
+ * (an estimate of) "n" grafts in the context of "build".
+ * At most one if node is recorded for each graft except the last,
+ * so "n" - 1 if nodes are sufficient for "n" grafts.
+ */
+static isl_stat isl_pending_guard_data_init(struct isl_pending_guard_data *data,
+	__isl_keep isl_ast_build *build, int n)
+{
+	isl_ctx *ctx;
+
+	ctx = isl_ast_build_get_ctx(build);
+	data->build = build;
+	data->allow_else = isl_options_get_ast_build_allow_else(ctx);
+	data->n_if = 0;
+	data->size = 0;
+	data->if_node = NULL;
+	data->res = NULL;
+	if (n > 1) {
+		data->if_node = isl_alloc_array(ctx, struct isl_if_node, n - 1);
+		if (!data->if_node)
+			return isl_stat_error;
+		data->size = n - 1;
+	}
+	data->res = isl_ast_graft_list_alloc(ctx, n);
+	if (!data->res)
+		return isl_stat_error;
+
+	return isl_stat_ok;
+}
+
+/* Free all memory allocated for "data".
+ */
+static void isl_pending_guard_data_clear(struct isl_pending_guard_data *data)
+{
+	clear_if_nodes(data->if_node, 0, data->n_if);
+	free(data->if_node);
+	isl_ast_graft_list_free(data->res);
+}
+
+/* Make sure there is room for an extra if node in data->if_node.
+ */
+static isl_stat isl_pending_guard_data_grow(struct isl_pending_guard_data *data)
+{
+	isl_ctx *ctx;
+	struct isl_if_node *if_node;
+
+	if (data->n_if < data->size)
+		return isl_stat_ok;
+
+	ctx = isl_ast_build_get_ctx(data->build);
+	if_node = isl_realloc_array(ctx, data->if_node, struct isl_if_node,
+					2 * data->size + 1);
+	if (!if_node)
+		return isl_stat_error;
+	data->if_node = if_node;
+	data->size = 2 * data->size + 1;
+
+	return isl_stat_ok;
+}
+
+/* Insert an if node around graft->node testing the condition encoded
+ * in graft->guard, assuming graft->guard involves any conditions,
+ * and append the result to data->res.
+ * "last" is set if "graft" is known to be the final graft.
  *
  * We keep track of a list of generated if nodes that can be extended
- * without changing the order of the elements in "list".
+ * without changing the order of the elements in data->res.
  * If the guard of a graft is a subset of either the guard or its complement
  * of one of those if nodes, then the node
  * of the new graft is inserted into the then or else branch of the last graft
@@ -534,122 +615,139 @@ static int clear_if_nodes(struct isl_if_node *if_node, int first, int n)
  * The guard of the node is then simplified based on the conditions
  * enforced at that then or else branch.
  * Otherwise, the current graft is appended to the list.
+ * Since no graft can be merged into the final graft,
+ * there is no need to keep track of an if node generated for that graft.
  *
  * We only construct else branches if allowed by the user.
  */
+static isl_stat insert_pending_guard(struct isl_pending_guard_data *data,
+	__isl_take isl_ast_graft *graft, int last)
+{
+	int j;
+	isl_set *guard;
+	int subset, found_then, found_else;
+	isl_ast_node *node;
+	isl_ast_build *build = data->build;
+
+	if (!graft)
+		return isl_stat_error;
+	subset = 0;
+	found_then = found_else = -1;
+	if (data->n_if > 0) {
+		isl_set *test;
+		test = isl_set_copy(graft->guard);
+		test = isl_set_intersect(test, isl_set_copy(build->domain));
+		for (j = data->n_if - 1; j >= 0; --j) {
+			subset = isl_set_is_subset(test,
+						data->if_node[j].guard);
+			if (subset < 0 || subset) {
+				found_then = j;
+				break;
+			}
+			if (!data->allow_else)
+				continue;
+			subset = isl_set_is_subset(test,
+						data->if_node[j].complement);
+			if (subset < 0 || subset) {
+				found_else = j;
+				break;
+			}
+		}
+		data->n_if = clear_if_nodes(data->if_node, j + 1, data->n_if);
+		isl_set_free(test);
+	}
+	if (subset < 0) {
+		isl_ast_graft_free(graft);
+		return isl_stat_error;
+	}
+
+	guard = isl_set_copy(graft->guard);
+	if (found_then >= 0)
+		graft->guard = isl_set_gist(graft->guard,
+			isl_set_copy(data->if_node[found_then].guard));
+	else if (found_else >= 0)
+		graft->guard = isl_set_gist(graft->guard,
+			isl_set_copy(data->if_node[found_else].complement));
+
+	node = graft->node;
+	if (!graft->guard)
+		graft = isl_ast_graft_free(graft);
+	graft = insert_pending_guard_node(graft, build);
+	if (graft && graft->node != node && !last) {
+		isl_set *set;
+		struct isl_if_node *if_node;
+
+		if (isl_pending_guard_data_grow(data) < 0) {
+			isl_set_free(guard);
+			isl_ast_graft_free(graft);
+			return isl_stat_error;
+		}
+		if_node = data->if_node;
+		if_node[data->n_if].node = graft->node;
+		if_node[data->n_if].guard = guard;
+		if (found_then >= 0)
+			set = if_node[found_then].guard;
+		else if (found_else >= 0)
+			set = if_node[found_else].complement;
+		else
+			set = build->domain;
+		set = isl_set_copy(set);
+		set = isl_set_subtract(set, isl_set_copy(guard));
+		if_node[data->n_if].complement = set;
+		data->n_if++;
+	} else
+		isl_set_free(guard);
+	if (!graft)
+		return isl_stat_error;
+
+	if (found_then >= 0)
+		data->res = extend_then(data->res,
+				data->if_node[found_then].node, graft, build);
+	else if (found_else >= 0)
+		data->res = extend_else(data->res,
+				data->if_node[found_else].node, graft, build);
+	else
+		data->res = isl_ast_graft_list_add(data->res, graft);
+
+	return data->res ? isl_stat_ok : isl_stat_error;
+}
+
+/* For each graft in "list",
+ * insert an if node around graft->node testing the condition encoded
+ * in graft->guard, assuming graft->guard involves any conditions.
+ * See insert_pending_guard for more details.
+ */
 static __isl_give isl_ast_graft_list *insert_pending_guard_nodes(
 	__isl_take isl_ast_graft_list *list,
 	__isl_keep isl_ast_build *build)
 {
-	int i, j, n, n_if;
-	int allow_else;
-	isl_ctx *ctx;
+	int i, n;
 	isl_ast_graft_list *res;
-	struct isl_if_node *if_node = NULL;
+	struct isl_pending_guard_data data;
 
 	if (!build || !list)
 		return isl_ast_graft_list_free(list);
 
-	ctx = isl_ast_build_get_ctx(build);
 	n = isl_ast_graft_list_n_ast_graft(list);
-
-	allow_else = isl_options_get_ast_build_allow_else(ctx);
-
-	n_if = 0;
-	if (n > 1) {
-		if_node = isl_alloc_array(ctx, struct isl_if_node, n - 1);
-		if (!if_node)
-			return isl_ast_graft_list_free(list);
+	if (isl_pending_guard_data_init(&data, build, n) < 0) {
+		isl_pending_guard_data_clear(&data);
+		return isl_ast_graft_list_free(list);
 	}
 
-	res = isl_ast_graft_list_alloc(ctx, n);
-
 	for (i = 0; i < n; ++i) {
-		isl_set *guard;
 		isl_ast_graft *graft;
-		int subset, found_then, found_else;
-		isl_ast_node *node;
 
 		graft = isl_ast_graft_list_get_ast_graft(list, i);
-		if (!graft)
+		if (insert_pending_guard(&data, graft, i == n - 1) < 0)
 			break;
-		subset = 0;
-		found_then = found_else = -1;
-		if (n_if > 0) {
-			isl_set *test;
-			test = isl_set_copy(graft->guard);
-			test = isl_set_intersect(test,
-						isl_set_copy(build->domain));
-			for (j = n_if - 1; j >= 0; --j) {
-				subset = isl_set_is_subset(test,
-							if_node[j].guard);
-				if (subset < 0 || subset) {
-					found_then = j;
-					break;
-				}
-				if (!allow_else)
-					continue;
-				subset = isl_set_is_subset(test,
-							if_node[j].complement);
-				if (subset < 0 || subset) {
-					found_else = j;
-					break;
-				}
-			}
-			n_if = clear_if_nodes(if_node, j + 1, n_if);
-			isl_set_free(test);
-		}
-		if (subset < 0) {
-			graft = isl_ast_graft_free(graft);
-			break;
-		}
-
-		guard = isl_set_copy(graft->guard);
-		if (found_then >= 0)
-			graft->guard = isl_set_gist(graft->guard,
-				isl_set_copy(if_node[found_then].guard));
-		else if (found_else >= 0)
-			graft->guard = isl_set_gist(graft->guard,
-				isl_set_copy(if_node[found_else].complement));
-
-		node = graft->node;
-		if (!graft->guard)
-			graft = isl_ast_graft_free(graft);
-		graft = insert_pending_guard_node(graft, build);
-		if (graft && graft->node != node && i != n - 1) {
-			isl_set *set;
-			if_node[n_if].node = graft->node;
-			if_node[n_if].guard = guard;
-			if (found_then >= 0)
-				set = if_node[found_then].guard;
-			else if (found_else >= 0)
-				set = if_node[found_else].complement;
-			else
-				set = build->domain;
-			set = isl_set_copy(set);
-			set = isl_set_subtract(set, isl_set_copy(guard));
-			if_node[n_if].complement = set;
-			n_if++;
-		} else
-			isl_set_free(guard);
-		if (!graft)
-			break;
-
-		if (found_then >= 0)
-			res = extend_then(res, if_node[found_then].node,
-						graft, build);
-		else if (found_else >= 0)
-			res = extend_else(res, if_node[found_else].node,
-						graft, build);
-		else
-			res = isl_ast_graft_list_add(res, graft);
 	}
+	res = data.res;
+	data.res = NULL;
 	if (i < n)
 		res = isl_ast_graft_list_free(res);
 
 	isl_ast_graft_list_free(list);
-	clear_if_nodes(if_node, 0, n_if);
-	free(if_node);
+	isl_pending_guard_data_clear(&data);
 	return res;
 }
 
@@ -991,6 +1089,139 @@ __isl_give isl_ast_node *isl_ast_node_from_graft_list(
 	return isl_ast_node_from_ast_node_list(node_list);
 }
 
+/* Internal data structure for passing the nodes corresponding
+ * to a sequence of grafts to a callback as soon as they are final.
+ *
+ * "build" is the build in which the grafts were constructed.
+ * "data" is used to insert if nodes for the pending guards.
+ * All elements of data.res except the last are final.
+ * "fn" is called on each final node with "user" as extra argument.
+ */
+struct isl_ast_graft_stream {
+	isl_ast_build *build;
+	struct isl_pending_guard_data data;
+
+	isl_stat (*fn)(__isl_take isl_ast_node *node, void *user);
+	void *user;
+};
+
+/* Create an isl_ast_graft_stream that passes the nodes corresponding
+ * to the grafts in the context of "build" that are added to the stream
+ * to "fn".
+ * Initially, no grafts are known.
+ */
+struct isl_ast_graft_stream *isl_ast_graft_stream_alloc(
+	__isl_keep isl_ast_build *build,
+	isl_stat (*fn)(__isl_take isl_ast_node *node, void *user), void *user)
+{
+	isl_ctx *ctx;
+	struct isl_ast_graft_stream *stream;
+
+	if (!build)
+		return NULL;
+
+	ctx = isl_ast_build_get_ctx(build);
+	stream = isl_calloc_type(ctx, struct isl_ast_graft_stream);
+	if (!stream)
+		return NULL;
+
+	stream->build = isl_ast_build_copy(build);
+	stream->fn = fn;
+	stream->user = user;
+	if (isl_pending_guard_data_init(&stream->data, stream->build, 0) < 0)
+		return isl_ast_graft_stream_free(stream);
+
+	return stream;
+}
+
+void *isl_ast_graft_stream_free(struct isl_ast_graft_stream *stream)
+{
+	if (!stream)
+		return NULL;
+
+	isl_pending_guard_data_clear(&stream->data);
+	isl_ast_build_free(stream->build);
+	free(stream);
+
+	return NULL;
+}
+
+/* Pass the nodes of the first "n" grafts collected by "stream"
+ * to stream->fn and remove these grafts from the stream.
+ * Each graft is removed before its node is passed to stream->fn
+ * such that the node is no longer referenced by the stream.
+ */
+static isl_stat emit_nodes(struct isl_ast_graft_stream *stream, int n)
+{
+	int i;
+
+	for (i = 0; i < n; ++i) {
+		isl_ast_graft *graft;
+		isl_ast_node *node;
+
+		graft = isl_ast_graft_list_get_ast_graft(stream->data.res, 0);
+		node = isl_ast_graft_get_node(graft);
+		isl_ast_graft_free(graft);
+		stream->data.res = isl_ast_graft_list_drop(stream->data.res,
+								0, 1);
+		if (!stream->data.res || !node) {
+			isl_ast_node_free(node);
+			return isl_stat_error;
+		}
+		if (stream->fn(node, stream->user) < 0)
+			return isl_stat_error;
+	}
+
+	return isl_stat_ok;
+}
+
+/* Add the grafts in "list" to "stream" and pass the nodes
+ * that have become final to stream->fn.
+ *
+ * The grafts are handled in the same way as in insert_pending_guard_nodes,
+ * except that it is not known which graft is the final graft.
+ * Since only the last element of stream->data.res can still be extended,
+ * all other elements are final.
+ */
+isl_stat isl_ast_graft_stream_add(struct isl_ast_graft_stream *stream,
+	__isl_take isl_ast_graft_list *list)
+{
+	int i, n;
+
+	if (!stream || !list)
+		goto error;
+
+	n = isl_ast_graft_list_n_ast_graft(list);
+	for (i = 0; i < n; ++i) {
+		isl_ast_graft *graft;
+
+		graft = isl_ast_graft_list_get_ast_graft(list, i);
+		if (insert_pending_guard(&stream->data, graft, 0) < 0)
+			goto error;
+	}
+	isl_ast_graft_list_free(list);
+
+	n = isl_ast_graft_list_n_ast_graft(stream->data.res);
+	return emit_nodes(stream, n - 1);
+error:
+	isl_ast_graft_list_free(list);
+	return isl_stat_error;
+}
+
+/* Pass the nodes of all remaining grafts in "stream" to stream->fn.
+ * This function should be called after all grafts have been added.
+ */
+isl_stat isl_ast_graft_stream_flush(struct isl_ast_graft_stream *stream)
+{
+	int n;
+
+	if (!stream)
+		return isl_stat_error;
+
+	n = isl_ast_graft_list_n_ast_graft(stream->data.res);
+	return emit_nodes(stream, n);
+}
+
 void *isl_ast_graft_free(__isl_take isl_ast_graft *graft)
 {
 	if (!graft)
@@ -89,6 +89,16 @@ __isl_give isl_ast_graft_list *isl_ast_graft_list_insert_pending_guard_nodes(
 __isl_give isl_ast_node *isl_ast_node_from_graft_list(
 	__isl_take isl_ast_graft_list *list, __isl_keep isl_ast_build *build);
 
+struct isl_ast_graft_stream;
+
+struct isl_ast_graft_stream *isl_ast_graft_stream_alloc(
+	__isl_keep isl_ast_build *build,
+	isl_stat (*fn)(__isl_take isl_ast_node *node, void *user), void *user);
+isl_stat isl_ast_graft_stream_add(struct isl_ast_graft_stream *stream,
+	__isl_take isl_ast_graft_list *list);
+isl_stat isl_ast_graft_stream_flush(struct isl_ast_graft_stream *stream);
+void *isl_ast_graft_stream_free(struct isl_ast_graft_stream *stream);
+
 __isl_give isl_basic_set *isl_ast_graft_list_extract_shared_enforced(
 	__isl_keep isl_ast_graft_list *list, __isl_keep isl_ast_build *build);
 __isl_give isl_set *isl_ast_graft_list_extract_hoistable_guard(
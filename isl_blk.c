@@ -10,9 +10,6 @@
 #include <isl_blk.h>
 #include <isl_ctx_private.h>
 
-/* The maximal number of cache misses before first element is evicted */
-#define ISL_BLK_MAX_MISS	100
-
 struct isl_blk isl_blk_empty()
 {
 	struct isl_blk block;
@@ -39,6 +36,39 @@ int isl_blk_is_error(struct isl_blk block)
 	return block.size == -1 && block.data == NULL;
 }
 
+/* Return the size class of a block of size "n", i.e.,
+ * the smallest i such that 2^i >= n.
+ */
+static int size_class(size_t n)
+{
+	int i = 0;
+
+	while (((size_t) 1 << i) < n)
+		++i;
+	return i;
+}
+
+/* Return the size of the blocks in size class "c".
+ */
+static size_t class_size(int c)
+{
+	return (size_t) 1 << c;
+}
+
+/* Return the size of a block that can hold "n" elements.
+ * If "n" belongs to one of the cached size classes, then
+ * the size is rounded up to the size of that class such that
+ * the block can be reused for any request in the same class.
+ */
+static size_t rounded_size(size_t n)
+{
+	int c = size_class(n);
+
+	if (c >= ISL_BLK_N_CLASS)
+		return n;
+	return class_size(c);
+}
+
 static void isl_blk_free_force(struct isl_ctx *ctx, struct isl_blk block)
 {
 	int i;
@@ -46,6 +76,7 @@ static void isl_blk_free_force(struct isl_ctx *ctx, struct isl_blk block)
 	for (i = 0; i < block.size; ++i)
 		isl_int_clear(block.data[i]);
 	free(block.data);
+	ctx->blk_size -= block.size;
 }
 
 static struct isl_blk extend(struct isl_ctx *ctx, struct isl_blk block,
@@ -57,6 +88,7 @@ static struct isl_blk extend(struct isl_ctx *ctx, struct isl_blk block,
 	if (block.size >= new_n)
 		return block;
 
+	new_n = rounded_size(new_n);
 	p = isl_realloc_array(ctx, block.data, isl_int, new_n);
 	if (!p) {
 		isl_blk_free_force(ctx, block);
@@ -66,42 +98,37 @@ static struct isl_blk extend(struct isl_ctx *ctx, struct isl_blk block,
 
 	for (i = block.size; i < new_n; ++i)
 		isl_int_init(block.data[i]);
+	ctx->blk_size += new_n - block.size;
+	if (ctx->blk_size > ctx->blk_peak)
+		ctx->blk_peak = ctx->blk_size;
 	block.size = new_n;
 
 	return block;
 }
 
+/* Allocate a block of (at least) "n" elements.
+ * If a previously freed block of the same size class is available,
+ * then reuse it.  Otherwise, allocate a new block with its size
+ * rounded up to that of the size class.
+ */
 struct isl_blk isl_blk_alloc(struct isl_ctx *ctx, size_t n)
 {
-	int i;
-	struct isl_blk block;
-
-	block = isl_blk_empty();
-	if (n && ctx->n_cached) {
-		int best = 0;
-		for (i = 1; ctx->cache[best].size != n && i < ctx->n_cached; ++i) {
-			if (ctx->cache[best].size < n) {
-				if (ctx->cache[i].size > ctx->cache[best].size)
-					best = i;
-			} else if (ctx->cache[i].size >= n &&
-				   ctx->cache[i].size < ctx->cache[best].size)
-					best = i;
-		}
-		if (ctx->cache[best].size < 2 * n + 100) {
-			block = ctx->cache[best];
-			if (--ctx->n_cached != best)
-				ctx->cache[best] = ctx->cache[ctx->n_cached];
-			if (best == 0)
-				ctx->n_miss = 0;
-		} else if (ctx->n_miss++ >= ISL_BLK_MAX_MISS) {
-			isl_blk_free_force(ctx, ctx->cache[0]);
-			if (--ctx->n_cached != 0)
-				ctx->cache[0] = ctx->cache[ctx->n_cached];
-			ctx->n_miss = 0;
-		}
+	int c;
+	struct isl_blk_cache *cache;
+
+	if (n == 0)
+		return isl_blk_empty();
+
+	c = size_class(n);
+	if (c < ISL_BLK_N_CLASS && ctx->blk_cache[c].n > 0) {
+		cache = &ctx->blk_cache[c];
+		ctx->blk_hit++;
+		ctx->blk_cached -= class_size(c);
+		return cache->blk[--cache->n];
 	}
 
-	return extend(ctx, block, n);
+	ctx->blk_miss++;
+	return extend(ctx, isl_blk_empty(), n);
 }
 
 struct isl_blk isl_blk_extend(struct isl_ctx *ctx, struct isl_blk block,
@@ -113,22 +140,46 @@ struct isl_blk isl_blk_extend(struct isl_ctx *ctx, struct isl_blk block,
 	return extend(ctx, block, new_n);
 }
 
+/* Free "block", keeping it in the cache of its size class
+ * if it has exactly the size of that class and if the cache is not full.
+ * The cache is considered to be full if it already holds
+ * ISL_BLK_CACHE_SIZE blocks of this size class or if adding the block
+ * would bring the total number of cached elements over
+ * ISL_BLK_CACHE_MAX_ELEMENTS.
+ */
 void isl_blk_free(struct isl_ctx *ctx, struct isl_blk block)
 {
+	int c;
+	struct isl_blk_cache *cache;
+
 	if (isl_blk_is_empty(block) || isl_blk_is_error(block))
 		return;
 
-	if (ctx->n_cached < ISL_BLK_CACHE_SIZE)
-		ctx->cache[ctx->n_cached++] = block;
-	else
+	c = size_class(block.size);
+	if (c >= ISL_BLK_N_CLASS || block.size != class_size(c)) {
+		isl_blk_free_force(ctx, block);
+		return;
+	}
+
+	cache = &ctx->blk_cache[c];
+	if (cache->n < ISL_BLK_CACHE_SIZE &&
+	    ctx->blk_cached + block.size <= ISL_BLK_CACHE_MAX_ELEMENTS) {
+		cache->blk[cache->n++] = block;
+		ctx->blk_cached += block.size;
+	} else
 		isl_blk_free_force(ctx, block);
 }
 
 void isl_blk_clear_cache(struct isl_ctx *ctx)
 {
-	int i;
+	int c, i;
+
+	for (c = 0; c < ISL_BLK_N_CLASS; ++c) {
+		struct isl_blk_cache *cache = &ctx->blk_cache[c];
 
-	for (i = 0; i < ctx->n_cached; ++i)
-		isl_blk_free_force(ctx, ctx->cache[i]);
-	ctx->n_cached = 0;
+		for (i = 0; i < cache->n; ++i)
+			isl_blk_free_force(ctx, cache->blk[i]);
+		cache->n = 0;
+	}
+	ctx->blk_cached = 0;
 }
@@ -21,7 +21,22 @@ struct isl_blk {
 	isl_int *data;
 };
 
+/* The maximal number of cached blocks per size class */
 #define ISL_BLK_CACHE_SIZE	20
+/* The number of size classes.  Size class i holds blocks of size 2^i.
+ * Only blocks in these size classes have their size rounded up.
+ */
+#define ISL_BLK_N_CLASS		12
+/* The maximal total number of elements in all cached blocks */
+#define ISL_BLK_CACHE_MAX_ELEMENTS	(1 << 14)
+
+/* A cache of previously freed blocks of a single size class.
+ * The elements of these blocks remain initialized.
+ */
+struct isl_blk_cache {
+	int n;
+	struct isl_blk blk[ISL_BLK_CACHE_SIZE];
+};
 
 struct isl_ctx;
 
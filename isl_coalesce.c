@@ -87,18 +87,46 @@ error:
 /* Compute the position of the inequalities of basic map "bmap_i"
  * (also represented by "tab_i", if not NULL) with respect to the basic map
  * represented by "tab_j".
+ *
+ * As soon as a separating inequality is found, the remaining
+ * inequalities are not considered since the caller will not be
+ * able to coalesce the two basic maps anyway.
+ * If "separating" is not NULL, then it points to the position
+ * of the inequality that separated "bmap_i" from some other
+ * basic map the last time such an inequality was found, or -1.
+ * Since pieces of a map that is being coalesced are often
+ * separated from many other pieces by the same inequality,
+ * this inequality is considered first, possibly avoiding
+ * the computation of the position of any other inequality.
+ * The position of the separating inequality is updated if a new one
+ * is found.  Note that the result is the same (apart from which
+ * elements are left unset after a separating inequality has been found)
+ * as when the inequalities are considered in order.
  */
 static int *ineq_status_in(__isl_keep isl_basic_map *bmap_i,
-	struct isl_tab *tab_i, struct isl_tab *tab_j)
+	struct isl_tab *tab_i, struct isl_tab *tab_j, int *separating)
 {
-	int k;
+	int k, first;
 	unsigned n_eq = bmap_i->n_eq;
 	int *ineq = isl_calloc_array(bmap_i->ctx, int, bmap_i->n_ineq);
 
 	if (!ineq)
 		return NULL;
 
+	first = separating ? *separating : -1;
+	if (first >= 0 && first < bmap_i->n_ineq &&
+	    !(tab_i && isl_tab_is_redundant(tab_i, n_eq + first))) {
+		ineq[first] = status_in(bmap_i->ineq[first], tab_j);
+		if (ineq[first] == STATUS_ERROR)
+			goto error;
+		if (ineq[first] == STATUS_SEPARATE)
+			return ineq;
+	} else
+		first = -1;
+
 	for (k = 0; k < bmap_i->n_ineq; ++k) {
+		if (k == first)
+			continue;
 		if (tab_i && isl_tab_is_redundant(tab_i, n_eq + k)) {
 			ineq[k] = STATUS_REDUNDANT;
 			continue;
@@ -106,8 +134,11 @@ static int *ineq_status_in(__isl_keep isl_basic_map *bmap_i,
 		ineq[k] = status_in(bmap_i->ineq[k], tab_j);
 		if (ineq[k] == STATUS_ERROR)
 			goto error;
-		if (ineq[k] == STATUS_SEPARATE)
+		if (ineq[k] == STATUS_SEPARATE) {
+			if (separating)
+				*separating = k;
 			break;
+		}
 	}
 
 	return ineq;
@@ -162,6 +193,19 @@ static int all(int *con, unsigned len, int status)
  * map should then be simplified such that we may be able to find
  * a definition among the constraints.
  *
+ * "separating" is the position of the inequality of "bmap" that
+ * was most recently found to separate "bmap" from another basic map
+ * or -1 if no such inequality has been found yet.
+ * It is only used to speed up ineq_status_in.
+ *
+ * "box" and "bounded" describe a box containing "bmap",
+ * derived from the constraints of "bmap" that involve a single variable.
+ * They are only set if "bmap" has no existentially quantified variables
+ * and if the box has been computed by get_box.
+ * For each variable k, box->el[2 * k] is a lower bound and
+ * box->el[2 * k + 1] is an upper bound, if the corresponding
+ * element of "bounded" is set.  Otherwise, there is no such bound.
+ *
  * "eq" and "ineq" are only set if we are currently trying to coalesce
  * this basic map with another basic map, in which case they represent
  * the position of the inequalities of this basic map with respect to
@@ -175,6 +219,9 @@ struct isl_coalesce_info {
 	uint32_t hull_hash;
 	int removed;
 	int simplify;
+	int separating;
+	isl_vec *box;
+	int *bounded;
 	int *eq;
 	int *ineq;
 };
@@ -242,11 +289,23 @@ static void clear_coalesce_info(int n, struct isl_coalesce_info *info)
 	for (i = 0; i < n; ++i) {
 		isl_basic_map_free(info[i].bmap);
 		isl_tab_free(info[i].tab);
+		isl_vec_free(info[i].box);
+		free(info[i].bounded);
 	}
 
 	free(info);
 }
 
+/* Drop the box of the basic map represented by "info", if any,
+ * such that it gets recomputed from the current basic map when needed.
+ */
+static void clear_box(struct isl_coalesce_info *info)
+{
+	info->box = isl_vec_free(info->box);
+	free(info->bounded);
+	info->bounded = NULL;
+}
+
 /* Drop the basic map represented by "info".
  * That is, clear the memory associated to the entry and
  * mark it as having been removed.
@@ -256,6 +315,7 @@ static void drop(struct isl_coalesce_info *info)
 	info->bmap = isl_basic_map_free(info->bmap);
 	isl_tab_free(info->tab);
 	info->tab = NULL;
+	clear_box(info);
 	info->removed = 1;
 }
 
@@ -1864,7 +1924,8 @@ static void set_ineq_status_in(struct isl_coalesce_info *info,
 {
 	if (info->ineq)
 		return;
-	info->ineq = ineq_status_in(info->bmap, info->tab, tab);
+	info->ineq = ineq_status_in(info->bmap, info->tab, tab,
+					&info->separating);
 }
 
 /* Free the memory allocated by the "eq" and "ineq" fields of "info".
@@ -2373,7 +2434,7 @@ static enum isl_change coalesce_with_expanded_divs(
 	if (any(info_i->eq, 2 * bmap->n_eq, STATUS_SEPARATE))
 		goto done;
 
-	info_i->ineq = ineq_status_in(bmap, NULL, info[j].tab);
+	info_i->ineq = ineq_status_in(bmap, NULL, info[j].tab, NULL);
 	if (bmap->n_ineq && !info_i->ineq)
 		goto error;
 	if (any(info_i->ineq, bmap->n_ineq, STATUS_ERROR))
@@ -2955,13 +3016,216 @@ static enum isl_change check_coalesce_eq(int i, int j,
 	return isl_change_none;
 }
 
+/* Update the box of the basic map represented by "info" based on
+ * the constraint "c" of "bmap", which is an equality if "eq" is set,
+ * assuming it involves only the variable x at position "pos"
+ * with a positive coefficient if "sgn" is positive.
+ *
+ * An inequality c_0 + a x >= 0 imposes the lower bound floor(-c_0/a)
+ * if a > 0 and the upper bound ceil(-c_0/a) if a < 0.
+ * An equality imposes both bounds.
+ * The bounds are rounded outward such that the box contains
+ * all rational points of "bmap" and not just its integer points.
+ * "t" is a temporary variable.
+ */
+static void update_box(struct isl_coalesce_info *info, isl_int *c, int pos,
+	int sgn, int eq, isl_int *t)
+{
+	int l;
+
+	for (l = 0; l < 2; ++l) {
+		int upper = (sgn < 0) ^ l;
+		isl_int *bound = &info->box->el[2 * pos + upper];
+
+		if (l == 1 && !eq)
+			break;
+		isl_int_neg(*t, c[0]);
+		if (upper)
+			isl_int_cdiv_q(*t, *t, c[1 + pos]);
+		else
+			isl_int_fdiv_q(*t, *t, c[1 + pos]);
+		if (info->bounded[2 * pos + upper] &&
+		    (upper ? isl_int_le(*bound, *t) : isl_int_ge(*bound, *t)))
+			continue;
+		isl_int_set(*bound, *t);
+		info->bounded[2 * pos + upper] = 1;
+	}
+}
+
+/* Compute the box of the basic map represented by "info",
+ * if it has not been computed already.
+ * Only constraints that involve a single variable are taken into account.
+ * Constraints that are marked redundant in the tableau are skipped
+ * since the tableau may have been relaxed after they were marked redundant
+ * (without updating the other constraints of the basic map),
+ * in which case they are no longer valid.
+ */
+static isl_stat get_box(struct isl_coalesce_info *info)
+{
+	int k;
+	int pos;
+	unsigned total;
+	isl_ctx *ctx;
+	isl_basic_map *bmap = info->bmap;
+	isl_int t;
+
+	if (info->box)
+		return isl_stat_ok;
+
+	ctx = isl_basic_map_get_ctx(bmap);
+	total = isl_basic_map_total_dim(bmap);
+	info->box = isl_vec_alloc(ctx, 2 * total);
+	info->bounded = isl_calloc_array(ctx, int, 2 * total);
+	if (!info->box || (total && !info->bounded)) {
+		clear_box(info);
+		return isl_stat_error;
+	}
+
+	isl_int_init(t);
+	for (k = 0; k < bmap->n_eq + bmap->n_ineq; ++k) {
+		int eq = k < bmap->n_eq;
+		isl_int *c = eq ? bmap->eq[k] : bmap->ineq[k - bmap->n_eq];
+
+		if (!eq && isl_tab_is_redundant(info->tab, k))
+			continue;
+		pos = isl_seq_first_non_zero(c + 1, total);
+		if (pos < 0)
+			continue;
+		if (isl_seq_first_non_zero(c + 1 + pos + 1,
+					    total - pos - 1) != -1)
+			continue;
+		update_box(info, c, pos, isl_int_sgn(c[1 + pos]), eq, &t);
+	}
+	isl_int_clear(t);
+
+	return isl_stat_ok;
+}
+
+/* Is the maximal value of the affine expression "c" (or its opposite
+ * if "sgn" is negative) over the box of the basic map
+ * represented by "info" known to be smaller than -g,
+ * with g the greatest common divisor of the variable coefficients of "c"?
+ * "t" and "g" are temporary variables.
+ */
+static int box_below_neg_gcd(struct isl_coalesce_info *info, isl_int *c,
+	int sgn, unsigned total, isl_int *t, isl_int *g)
+{
+	int k;
+
+	if (sgn > 0)
+		isl_int_set(*t, c[0]);
+	else
+		isl_int_neg(*t, c[0]);
+	for (k = 0; k < total; ++k) {
+		int upper;
+
+		if (isl_int_is_zero(c[1 + k]))
+			continue;
+		upper = sgn * isl_int_sgn(c[1 + k]) > 0;
+		if (!info->bounded[2 * k + upper])
+			return 0;
+		if (sgn > 0)
+			isl_int_addmul(*t, c[1 + k], info->box->el[2 * k + upper]);
+		else
+			isl_int_submul(*t, c[1 + k], info->box->el[2 * k + upper]);
+	}
+
+	isl_seq_gcd(c + 1, total, g);
+	isl_int_add(*t, *t, *g);
+	return isl_int_is_neg(*t);
+}
+
+/* Is there any (non-redundant) constraint of the basic map represented
+ * by "info_i" that is guaranteed to be reported as separate
+ * with respect to the basic map represented by "info_j"
+ * based on the box of the latter?
+ *
+ * isl_tab_ineq_type reports a constraint as separate if its maximal
+ * (rational) value over the other basic map is smaller than -1,
+ * unless the constraint is of the form c (-1 - r), with c a positive
+ * constant and r a variable of the tableau, in which case
+ * the constraint is reported as adjacent.
+ * If the other basic map has no equalities, then each variable
+ * of its tableau is a unique integer affine expression, so that
+ * c needs to divide the greatest common divisor g of
+ * the variable coefficients of the constraint.
+ * The maximal value of an adjacent constraint is then -c >= -g.
+ * A constraint is therefore guaranteed to be reported as separate
+ * if its maximal value over a box containing the other basic map
+ * is smaller than -g.
+ * No conclusion is drawn if the other basic map has any equalities.
+ * Since redundant inequalities are not considered by ineq_status_in,
+ * they are skipped here as well.
+ */
+static int any_separate_by_box(struct isl_coalesce_info *info_i,
+	struct isl_coalesce_info *info_j, isl_int *t, isl_int *g)
+{
+	int k;
+	isl_basic_map *bmap = info_i->bmap;
+	unsigned total = isl_basic_map_total_dim(bmap);
+
+	if (info_j->bmap->n_eq != 0 || info_j->tab->n_dead != 0)
+		return 0;
+
+	for (k = 0; k < bmap->n_eq; ++k) {
+		if (box_below_neg_gcd(info_j, bmap->eq[k], 1, total, t, g) ||
+		    box_below_neg_gcd(info_j, bmap->eq[k], -1, total, t, g))
+			return 1;
+	}
+	for (k = 0; k < bmap->n_ineq; ++k) {
+		if (isl_tab_is_redundant(info_i->tab, bmap->n_eq + k))
+			continue;
+		if (box_below_neg_gcd(info_j, bmap->ineq[k], 1, total, t, g))
+			return 1;
+	}
+
+	return 0;
+}
+
+/* Are the basic maps represented by info[i] and info[j] known
+ * not to be coalescible based on their boxes?
+ *
+ * This is only checked if neither basic map has any existentially
+ * quantified variables, in which case coalesce_pair calls
+ * coalesce_local_pair, which returns isl_change_none
+ * as soon as it finds a constraint of either basic map that
+ * is separate with respect to the other basic map.
+ * Detecting such a constraint using the boxes avoids
+ * the computation of the positions of the constraints using
+ * the tableaus, which requires solving LP problems.
+ * This is especially useful for maps with many pieces
+ * that are far apart.
+ */
+static isl_bool separated_by_box(int i, int j, struct isl_coalesce_info *info)
+{
+	int separated;
+	isl_int t, g;
+
+	if (info[i].bmap->n_div != 0 || info[j].bmap->n_div != 0)
+		return isl_bool_false;
+	if (get_box(&info[i]) < 0 || get_box(&info[j]) < 0)
+		return isl_bool_error;
+
+	isl_int_init(t);
+	isl_int_init(g);
+	separated = any_separate_by_box(&info[i], &info[j], &t, &g) ||
+		    any_separate_by_box(&info[j], &info[i], &t, &g);
+	isl_int_clear(g);
+	isl_int_clear(t);
+
+	return separated ? isl_bool_true : isl_bool_false;
+}
+
 /* Check if the union of the given pair of basic maps
  * can be represented by a single basic map.
  * If so, replace the pair by the single basic map and return
  * isl_change_drop_first, isl_change_drop_second or isl_change_fuse.
  * Otherwise, return isl_change_none.
  *
- * We first check if the two basic maps live in the same local space,
+ * We first perform a quick check based on bounds on the variables
+ * to see if the two basic maps are obviously too far apart.
+ *
+ * We then check if the two basic maps live in the same local space,
  * after aligning the divs that differ by only an integer constant.
  * If so, we do the complete check.  Otherwise, we check if they have
  * the same number of integer divisions and can be coalesced, if one is
@@ -2973,8 +3237,17 @@ static enum isl_change coalesce_pair(int i, int j,
 	struct isl_coalesce_info *info)
 {
 	int same;
+	isl_bool separated;
 	enum isl_change change;
 
+	info[i].bmap->ctx->stats->coalesce_pair_tests++;
+
+	separated = separated_by_box(i, j, info);
+	if (separated < 0)
+		return isl_change_error;
+	if (separated)
+		return isl_change_none;
+
 	if (harmonize_divs(&info[i], &info[j]) < 0)
 		return isl_change_error;
 	same = same_divs(info[i].bmap, info[j].bmap);
@@ -3035,6 +3308,10 @@ static int coalesce_range(isl_ctx *ctx, struct isl_coalesce_info *info,
 					"basic map unexpectedly removed",
 					return -1);
 			changed = coalesce_pair(i, j, info);
+			if (changed != isl_change_none) {
+				clear_box(&info[i]);
+				clear_box(&info[j]);
+			}
 			switch (changed) {
 			case isl_change_error:
 				return -1;
@@ -3174,6 +3451,7 @@ struct isl_map *isl_map_coalesce(struct isl_map *map)
 		if (!map->p[i])
 			goto error;
 		info[i].bmap = isl_basic_map_copy(map->p[i]);
+		info[i].separating = -1;
 		info[i].tab = isl_tab_from_basic_map(info[i].bmap, 0);
 		if (!info[i].tab)
 			goto error;
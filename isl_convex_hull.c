@@ -21,6 +21,7 @@
 #include <isl_options_private.h>
 #include "isl_equalities.h"
 #include "isl_tab.h"
+#include "isl_sample.h"
 #include <isl_sort.h>
 
 static struct isl_basic_set *uset_convex_hull_wrap_bounded(struct isl_set *set);
@@ -907,13 +908,11 @@ error:
 
 /* Is the set bounded for each value of the parameters?
  */
-int isl_basic_set_is_bounded(__isl_keep isl_basic_set *bset)
+static int basic_set_is_bounded(__isl_keep isl_basic_set *bset)
 {
 	struct isl_tab *tab;
 	int bounded;
 
-	if (!bset)
-		return -1;
 	if (isl_basic_set_plain_is_empty(bset))
 		return 1;
 
@@ -923,6 +922,17 @@ int isl_basic_set_is_bounded(__isl_keep isl_basic_set *bset)
 	return bounded;
 }
 
+/* Is the set bounded for each value of the parameters?
+ * The result may be taken from the sample cache.
+ */
+int isl_basic_set_is_bounded(__isl_keep isl_basic_set *bset)
+{
+	if (!bset)
+		return -1;
+
+	return isl_basic_set_cached_is_bounded(bset, &basic_set_is_bounded);
+}
+
 /* Is the image bounded for each value of the parameters and
  * the domain variables?
  */
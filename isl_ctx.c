@@ -7,9 +7,13 @@
  * Computerwetenschappen, Celestijnenlaan 200A, B-3001 Leuven, Belgium
  */
 
+#include <string.h>
 #include <isl_ctx_private.h>
+#include <isl_map_private.h>
 #include <isl/vec.h>
+#include <isl/printer.h>
 #include <isl_options_private.h>
+#include <isl_sample.h>
 
 #define __isl_calloc(type,size)		((type *)calloc(1, size))
 #define __isl_calloc_type(type)		__isl_calloc(type,sizeof(type))
@@ -39,6 +43,11 @@ static void *check_non_null(isl_ctx *ctx, void *p, size_t size)
  *
  * In particular, we should stop if the user has explicitly aborted
  * the computation or if the maximal number of operations has been exceeded.
+ * We should also stop if the internal soft limit on the number
+ * of operations has been reached, but since this limit is not set
+ * by the user, this is not reported through isl_handle_error.
+ * Only the error code is set such that the caller that set the limit
+ * can detect the situation.
  */
 int isl_ctx_next_operation(isl_ctx *ctx)
 {
@@ -51,6 +60,11 @@ int isl_ctx_next_operation(isl_ctx *ctx)
 	if (ctx->max_operations && ctx->operations >= ctx->max_operations)
 		isl_die(ctx, isl_error_quota,
 			"maximal number of operations exceeded", return -1);
+	if (ctx->soft_max_operations &&
+	    ctx->operations >= ctx->soft_max_operations) {
+		isl_ctx_set_error(ctx, isl_error_quota);
+		return -1;
+	}
 	ctx->operations++;
 	return 0;
 }
@@ -153,6 +167,7 @@ void *isl_ctx_peek_options(isl_ctx *ctx, struct isl_args *args)
 
 isl_ctx *isl_ctx_alloc_with_options(struct isl_args *args, void *user_opt)
 {
+	int i;
 	struct isl_ctx *ctx = NULL;
 	struct isl_options *opt = NULL;
 	int opt_allocated = 0;
@@ -199,13 +214,19 @@ isl_ctx *isl_ctx_alloc_with_options(struct isl_args *args, void *user_opt)
 
 	isl_int_init(ctx->normalize_gcd);
 
-	ctx->n_cached = 0;
-	ctx->n_miss = 0;
+	for (i = 0; i < ISL_BLK_N_CLASS; ++i)
+		ctx->blk_cache[i].n = 0;
+	ctx->blk_cached = 0;
+	ctx->blk_hit = 0;
+	ctx->blk_miss = 0;
+	ctx->blk_size = 0;
+	ctx->blk_peak = 0;
 
 	ctx->error = isl_error_none;
 
 	ctx->operations = 0;
 	isl_ctx_set_max_operations(ctx, ctx->opt->max_operations);
+	ctx->soft_max_operations = 0;
 
 	return ctx;
 error:
@@ -240,13 +261,27 @@ void isl_ctx_deref(struct isl_ctx *ctx)
  */
 static void print_stats(isl_ctx *ctx)
 {
+	isl_printer *p;
+
 	fprintf(stderr, "operations: %lu\n", ctx->operations);
+	fprintf(stderr, "block cache hits: %lu\n", ctx->blk_hit);
+	fprintf(stderr, "block cache misses: %lu\n", ctx->blk_miss);
+	fprintf(stderr, "peak block elements: %lu\n",
+		(unsigned long) ctx->blk_peak);
+	fprintf(stderr, "peak block bytes: %lu\n",
+		(unsigned long) (ctx->blk_peak * sizeof(isl_int)));
+	p = isl_printer_to_file(ctx, stderr);
+	p = isl_printer_set_yaml_style(p, ISL_YAML_STYLE_BLOCK);
+	p = isl_printer_print_stats(p, ctx->stats);
+	isl_printer_free(p);
 }
 
 void isl_ctx_free(struct isl_ctx *ctx)
 {
 	if (!ctx)
 		return;
+	isl_sample_cache_clear(ctx);
+	isl_coefficients_cache_clear(ctx);
 	if (ctx->ref != 0)
 		isl_die(ctx, isl_error_invalid,
 			"isl_ctx freed, but some objects still reference it",
@@ -340,3 +375,19 @@ void isl_ctx_reset_operations(isl_ctx *ctx)
 		return;
 	ctx->operations = 0;
 }
+
+/* Return the statistics collected by "ctx".
+ */
+const struct isl_stats *isl_ctx_get_stats(isl_ctx *ctx)
+{
+	return ctx ? ctx->stats : NULL;
+}
+
+/* Reset the statistics collected by "ctx".
+ */
+void isl_ctx_reset_stats(isl_ctx *ctx)
+{
+	if (!ctx)
+		return;
+	memset(ctx->stats, 0, sizeof(*ctx->stats));
+}
@@ -1,6 +1,9 @@
 #include <isl/ctx.h>
 #include <isl_blk.h>
 
+struct isl_sample_cache;
+struct isl_coefficients_cache;
+
 struct isl_ctx {
 	int			ref;
 
@@ -18,17 +21,28 @@ struct isl_ctx {
 
 	isl_int			normalize_gcd;
 
-	int			n_cached;
-	int			n_miss;
-	struct isl_blk		cache[ISL_BLK_CACHE_SIZE];
+	struct isl_blk_cache	blk_cache[ISL_BLK_N_CLASS];
+	size_t			blk_cached;
+	unsigned long		blk_hit;
+	unsigned long		blk_miss;
+	size_t			blk_size;
+	size_t			blk_peak;
 	struct isl_hash_table	id_table;
 
+	struct isl_sample_cache	*sample_cache;
+	struct isl_coefficients_cache	*coefficients_cache;
+
 	enum isl_error		error;
 
 	int			abort;
 
 	unsigned long		operations;
 	unsigned long		max_operations;
+	unsigned long		soft_max_operations;
+
+	void			(*schedule_trace)(const char *record,
+					void *user);
+	void			*schedule_trace_user;
 };
 
 int isl_ctx_next_operation(isl_ctx *ctx);
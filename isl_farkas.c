@@ -8,10 +8,13 @@
  * 91893 Orsay, France 
  */
 
+#include <isl_ctx_private.h>
 #include <isl_map_private.h>
 #include <isl/set.h>
+#include <isl/map_to_basic_set.h>
 #include <isl_space_private.h>
 #include <isl_seq.h>
+#include <isl_options_private.h>
 
 /*
  * Let C be a cone and define
@@ -292,13 +295,119 @@ error:
 	return NULL;
 }
 
+/* A cache of results of isl_basic_set_coefficients,
+ * keyed on the input basic set, viewed as a map with
+ * a zero-dimensional domain.
+ * "n" is the number of entries in "hmap".
+ * "size" is the maximal number of entries.
+ */
+struct isl_coefficients_cache {
+	int size;
+	int n;
+	isl_map_to_basic_set *hmap;
+};
+
+/* Free the coefficients cache of "ctx", if any.
+ */
+void isl_coefficients_cache_clear(isl_ctx *ctx)
+{
+	if (!ctx || !ctx->coefficients_cache)
+		return;
+
+	isl_map_to_basic_set_free(ctx->coefficients_cache->hmap);
+	free(ctx->coefficients_cache);
+	ctx->coefficients_cache = NULL;
+}
+
+/* Return the coefficients cache of "ctx", holding at most "size" entries,
+ * creating it if needed.
+ * If the size of the cache has changed since it was created,
+ * then the cache is cleared first.
+ */
+static struct isl_coefficients_cache *get_coefficients_cache(isl_ctx *ctx,
+	int size)
+{
+	struct isl_coefficients_cache *cache;
+
+	if (ctx->coefficients_cache && ctx->coefficients_cache->size != size)
+		isl_coefficients_cache_clear(ctx);
+	if (ctx->coefficients_cache)
+		return ctx->coefficients_cache;
+
+	cache = isl_calloc_type(ctx, struct isl_coefficients_cache);
+	if (!cache)
+		return NULL;
+	cache->hmap = isl_map_to_basic_set_alloc(ctx, size);
+	if (!cache->hmap) {
+		free(cache);
+		return NULL;
+	}
+	cache->size = size;
+	ctx->coefficients_cache = cache;
+
+	return cache;
+}
+
+/* Store "coeff" as the set of coefficients of "key" in "cache".
+ * If the cache is full, then all entries are dropped first.
+ * The dependence relations passed to the scheduler are typically
+ * all considered during a single scheduler invocation and
+ * then reconsidered during the next invocation, so there is
+ * little point in keeping track of which entries are used most recently.
+ */
+static isl_stat coefficients_cache_add(isl_ctx *ctx,
+	struct isl_coefficients_cache *cache,
+	__isl_take isl_map *key, __isl_keep isl_basic_set *coeff)
+{
+	if (cache->n >= cache->size) {
+		isl_map_to_basic_set_free(cache->hmap);
+		cache->hmap = isl_map_to_basic_set_alloc(ctx, cache->size);
+		cache->n = 0;
+	}
+	cache->hmap = isl_map_to_basic_set_set(cache->hmap, key,
+					isl_basic_set_copy(coeff));
+	if (!cache->hmap) {
+		isl_coefficients_cache_clear(ctx);
+		return isl_stat_error;
+	}
+	cache->n++;
+
+	return isl_stat_ok;
+}
+
+/* Compute the set of coefficients of "bset" using the Farkas lemma,
+ * without looking at the coefficients cache.
+ */
+static __isl_give isl_basic_set *basic_set_coefficients(
+	__isl_take isl_basic_set *bset)
+{
+	isl_space *dim;
+
+	dim = isl_basic_set_get_space(bset);
+	dim = isl_space_coefficients(dim);
+
+	return farkas(dim, bset, 1);
+}
+
 /* Construct a basic set containing the tuples of coefficients of all
  * valid affine constraints on the given basic set.
+ *
+ * If the coefficients-cache-size option is positive, then
+ * the result is looked up in (and, if it is not found, stored in)
+ * a cache that is kept in the isl_ctx.  Since the cache survives
+ * across calls, repeated invocations of the scheduler on
+ * the same dependence relations only need to apply the Farkas lemma
+ * to each of them once.
  */
 __isl_give isl_basic_set *isl_basic_set_coefficients(
 	__isl_take isl_basic_set *bset)
 {
-	isl_space *dim;
+	isl_ctx *ctx;
+	int size;
+	isl_map *key;
+	isl_maybe_isl_basic_set m;
+	isl_basic_set *coeff;
+	struct isl_coefficients_cache *cache;
 
 	if (!bset)
 		return NULL;
@@ -307,10 +416,40 @@ __isl_give isl_basic_set *isl_basic_set_coefficients(
 			"input set not allowed to have local variables",
 			goto error);
 
-	dim = isl_basic_set_get_space(bset);
-	dim = isl_space_coefficients(dim);
+	ctx = isl_basic_set_get_ctx(bset);
+	size = ctx->opt->coefficients_cache_size;
+	if (size <= 0) {
+		isl_coefficients_cache_clear(ctx);
+		return basic_set_coefficients(bset);
+	}
 
-	return farkas(dim, bset, 1);
+	cache = get_coefficients_cache(ctx, size);
+	if (!cache)
+		goto error;
+	key = isl_map_from_range(isl_set_from_basic_set(
+						isl_basic_set_copy(bset)));
+	m = isl_map_to_basic_set_try_get(cache->hmap, key);
+	if (m.valid < 0)
+		goto error_key;
+	if (m.valid) {
+		ctx->stats->coefficients_cache_hits++;
+		isl_map_free(key);
+		isl_basic_set_free(bset);
+		return m.value;
+	}
+	ctx->stats->coefficients_cache_misses++;
+
+	coeff = basic_set_coefficients(bset);
+	if (!coeff) {
+		isl_map_free(key);
+		return NULL;
+	}
+	if (coefficients_cache_add(ctx, cache, key, coeff) < 0)
+		return isl_basic_set_free(coeff);
+
+	return coeff;
+error_key:
+	isl_map_free(key);
 error:
 	isl_basic_set_free(bset);
 	return NULL;
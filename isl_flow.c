@@ -16,6 +16,8 @@
  * and Ecole Normale Superieure, 45 rue d'Ulm, 75230 Paris, France
  */
 
+#include <isl_ctx_private.h>
+#include <isl_map_private.h>
 #include <isl/set.h>
 #include <isl/map.h>
 #include <isl/union_set.h>
@@ -23,6 +25,7 @@
 #include <isl/flow.h>
 #include <isl/schedule_node.h>
 #include <isl_sort.h>
+#include <isl_space_private.h>
 
 enum isl_restriction_type {
 	isl_restriction_type_empty,
@@ -172,6 +175,10 @@ struct isl_labeled_map {
  *
  * restrict_fn is a callback that (if not NULL) will be called
  * right before any lexicographical maximization.
+ *
+ * lexmax_cache (if not NULL) is a cache of partial lexicographic maxima
+ * that is shared by all isl_access_info objects created during
+ * the same dataflow analysis.  It is not owned by the isl_access_info.
  */
 struct isl_access_info {
 	isl_map				*domain_map;
@@ -181,6 +188,8 @@ struct isl_access_info {
 	isl_access_restrict		restrict_fn;
 	void				*restrict_user;
 
+	struct isl_hash_table		*lexmax_cache;
+
 	int		    		max_source;
 	int		    		n_must;
 	int		    		n_may;
@@ -515,6 +524,166 @@ static __isl_give isl_map *after_at_level(__isl_take isl_space *dim, int level)
 	return isl_map_from_basic_map(bmap);
 }
 
+/* An entry in a cache of partial lexicographic maxima.
+ * "res" and "empty" are the result of calling isl_map_partial_lexmax
+ * on "dep" and "sink".
+ */
+struct isl_flow_lexmax_cache_entry {
+	isl_map *dep;
+	isl_set *sink;
+	isl_map *res;
+	isl_set *empty;
+};
+
+/* Allocate a cache of partial lexicographic maxima.
+ */
+static struct isl_hash_table *isl_flow_lexmax_cache_alloc(isl_ctx *ctx)
+{
+	return isl_hash_table_alloc(ctx, 0);
+}
+
+static isl_stat free_lexmax_cache_entry(void **entry, void *user)
+{
+	struct isl_flow_lexmax_cache_entry *cache_entry = *entry;
+
+	isl_map_free(cache_entry->dep);
+	isl_set_free(cache_entry->sink);
+	isl_map_free(cache_entry->res);
+	isl_set_free(cache_entry->empty);
+	free(cache_entry);
+
+	return isl_stat_ok;
+}
+
+/* Free the cache of partial lexicographic maxima "cache".
+ */
+static void isl_flow_lexmax_cache_free(isl_ctx *ctx,
+	struct isl_hash_table *cache)
+{
+	if (!cache)
+		return;
+	isl_hash_table_foreach(ctx, cache, &free_lexmax_cache_entry, NULL);
+	isl_hash_table_free(ctx, cache);
+}
+
+/* Does the cache entry "entry" correspond to the input
+ * of the partial lexicographic maximization "val",
+ * given in the form of an isl_flow_lexmax_cache_entry without result?
+ */
+static int has_lexmax_input(const void *entry, const void *val)
+{
+	const struct isl_flow_lexmax_cache_entry *cache_entry = entry;
+	const struct isl_flow_lexmax_cache_entry *input = val;
+	isl_bool equal;
+
+	equal = isl_map_plain_is_equal(cache_entry->dep, input->dep);
+	if (equal < 0 || !equal)
+		return 0;
+	equal = isl_set_plain_is_equal(cache_entry->sink, input->sink);
+	return equal == isl_bool_true;
+}
+
+/* Compute the partial lexicographic maximum of "dep" on domain "sink",
+ * reusing a previously computed result from acc->lexmax_cache
+ * if the same problem has been solved before during
+ * the current dataflow analysis.
+ * If the cache is not available, then simply call isl_map_partial_lexmax.
+ *
+ * The domain of "dep" refers to the sink statement, so that
+ * the problems for different sinks that access the same array
+ * in the same way (with respect to the same prefix schedule)
+ * only differ in the name and nesting of this domain.
+ * The domain is therefore replaced by an anonymous flat space
+ * before looking up the problem in the cache and
+ * the original space is restored in the result.
+ *
+ * The problem is trivial if "sink" is obviously empty.
+ * This happens frequently since the set of sink iterations
+ * that have only been matched to may sources is usually empty.
+ * Such problems are handled directly without consulting the cache.
+ */
+static __isl_give isl_map *cached_partial_lexmax(
+	__isl_keep isl_access_info *acc, __isl_take isl_map *dep,
+	__isl_take isl_set *sink, __isl_give isl_set **empty)
+{
+	isl_ctx *ctx;
+	uint32_t hash;
+	isl_space *space, *anonymous;
+	struct isl_hash_table_entry *entry;
+	struct isl_flow_lexmax_cache_entry input;
+	struct isl_flow_lexmax_cache_entry *cache_entry;
+	isl_map *res;
+
+	if (!dep || !sink)
+		goto error;
+	if (isl_set_plain_is_empty(sink)) {
+		space = isl_map_get_space(dep);
+		isl_map_free(dep);
+		*empty = sink;
+		return isl_map_empty(space);
+	}
+	if (!acc->lexmax_cache)
+		return isl_map_partial_lexmax(dep, sink, empty);
+
+	ctx = isl_map_get_ctx(dep);
+	space = isl_map_get_space(dep);
+	anonymous = isl_space_flatten_domain(isl_space_copy(space));
+	anonymous = isl_space_reset_tuple_id(anonymous, isl_dim_in);
+	sink = isl_set_reset_space(sink,
+				isl_space_domain(isl_space_copy(anonymous)));
+	dep = isl_map_reset_space(dep, anonymous);
+	if (!dep || !sink)
+		goto error_space;
+
+	hash = isl_hash_init();
+	isl_hash_hash(hash, isl_map_get_hash(dep));
+	isl_hash_hash(hash, isl_set_get_hash(sink));
+	input.dep = dep;
+	input.sink = sink;
+	entry = isl_hash_table_find(ctx, acc->lexmax_cache, hash,
+					&has_lexmax_input, &input, 1);
+	if (!entry)
+		goto error_space;
+	if (entry->data) {
+		ctx->stats->flow_lexmax_cache_hits++;
+		cache_entry = entry->data;
+		isl_map_free(dep);
+		isl_set_free(sink);
+		res = isl_map_copy(cache_entry->res);
+		*empty = isl_set_copy(cache_entry->empty);
+	} else {
+		ctx->stats->flow_lexmax_cache_misses++;
+		cache_entry = isl_calloc_type(ctx,
+					struct isl_flow_lexmax_cache_entry);
+		if (!cache_entry) {
+			isl_hash_table_remove(ctx, acc->lexmax_cache, entry);
+			goto error_space;
+		}
+		cache_entry->dep = isl_map_copy(dep);
+		cache_entry->sink = isl_set_copy(sink);
+		res = isl_map_partial_lexmax(dep, sink, empty);
+		cache_entry->res = isl_map_copy(res);
+		cache_entry->empty = isl_set_copy(*empty);
+		entry->data = cache_entry;
+		if (!res || !*empty) {
+			isl_hash_table_remove(ctx, acc->lexmax_cache, entry);
+			free_lexmax_cache_entry((void **) &cache_entry, NULL);
+		}
+	}
+
+	*empty = isl_set_reset_space(*empty,
+				isl_space_domain(isl_space_copy(space)));
+	res = isl_map_reset_space(res, space);
+	return res;
+error_space:
+	isl_space_free(space);
+error:
+	isl_map_free(dep);
+	isl_set_free(sink);
+	*empty = NULL;
+	return NULL;
+}
+
 /* Compute the partial lexicographic maximum of "dep" on domain "sink",
  * but first check if the user has set acc->restrict_fn and if so
  * update either the input or the output of the maximization problem
@@ -526,6 +695,7 @@ static __isl_give isl_map *after_at_level(__isl_take isl_space *dim, int level)
  * sink array elements by applying acc->domain_map.
  * Similarly, the sink restriction specified by the user needs to be
  * converted back to the wrapped map.
+ * The actual maximization is performed by cached_partial_lexmax.
  */
 static __isl_give isl_map *restricted_partial_lexmax(
 	__isl_keep isl_access_info *acc, __isl_take isl_map *dep,
@@ -538,7 +708,7 @@ static __isl_give isl_map *restricted_partial_lexmax(
 	isl_map *res;
 
 	if (!acc->restrict_fn)
-		return isl_map_partial_lexmax(dep, sink, empty);
+		return cached_partial_lexmax(acc, dep, sink, empty);
 
 	source_map = isl_map_copy(dep);
 	source_map = isl_map_apply_domain(source_map,
@@ -564,7 +734,7 @@ static __isl_give isl_map *restricted_partial_lexmax(
 		dep = isl_map_empty(space);
 	}
 
-	res = isl_map_partial_lexmax(dep, sink, empty);
+	res = cached_partial_lexmax(acc, dep, sink, empty);
 
 	if (restr->type == isl_restriction_type_output)
 		res = isl_map_intersect_range(res, isl_set_copy(restr->source));
@@ -1813,10 +1983,29 @@ static __isl_give isl_union_flow *isl_union_flow_drop_schedule(
 	return flow;
 }
 
+/* The source accesses to a given array.
+ * "array" is the space of the array.
+ * "source"[1] contains the must sources and "source"[0] the may sources.
+ */
+struct isl_compute_flow_array {
+	isl_space *array;
+	isl_map_list *source[2];
+};
+
+/* Data used in compute_flow_union_map.
+ *
+ * "arrays" is a hash table of isl_compute_flow_array objects
+ * containing the sources grouped per accessed array, such that
+ * the sources that access the same array as a given sink
+ * can be found without considering all the other sources.
+ * "lexmax_cache" is a cache of partial lexicographic maxima
+ * shared by the analyses of the individual sinks.
+ */
 struct isl_compute_flow_data {
 	isl_union_map *must_source;
 	isl_union_map *may_source;
 	isl_union_flow *flow;
+	struct isl_hash_table *arrays;
 
 	int count;
 	int must;
@@ -1824,52 +2013,125 @@ struct isl_compute_flow_data {
 	struct isl_sched_info *sink_info;
 	struct isl_sched_info **source_info;
 	isl_access_info *accesses;
+
+	struct isl_hash_table *lexmax_cache;
 };
 
-static isl_stat count_matching_array(__isl_take isl_map *map, void *user)
+static int has_array(const void *entry, const void *val)
 {
-	int eq;
-	isl_space *dim;
-	struct isl_compute_flow_data *data;
+	const struct isl_compute_flow_array *array = entry;
+	isl_space *space = (isl_space *) val;
 
-	data = (struct isl_compute_flow_data *)user;
+	return isl_space_is_equal(array->array, space);
+}
 
-	dim = isl_space_range(isl_map_get_space(map));
+/* Return the entry in data->arrays for the array space "space".
+ * If there is no such entry and "reserve" is set, then create one.
+ * If there is no such entry and "reserve" is not set, then return NULL.
+ */
+static struct isl_hash_table_entry *find_array(
+	struct isl_compute_flow_data *data, __isl_keep isl_space *space,
+	int reserve)
+{
+	isl_ctx *ctx;
+	uint32_t hash;
 
-	eq = isl_space_is_equal(dim, data->dim);
+	ctx = isl_space_get_ctx(space);
+	hash = isl_space_get_hash(space);
+	return isl_hash_table_find(ctx, data->arrays, hash,
+					&has_array, space, reserve);
+}
 
-	isl_space_free(dim);
-	isl_map_free(map);
+/* Add the source access "map" to the group of sources
+ * accessing the same array in data->arrays, creating the group
+ * if needed.  data->must indicates whether "map" is a must source.
+ */
+static isl_stat group_source(__isl_take isl_map *map, void *user)
+{
+	struct isl_compute_flow_data *data = user;
+	struct isl_hash_table_entry *entry;
+	struct isl_compute_flow_array *array;
+	isl_ctx *ctx;
+	isl_space *space;
 
-	if (eq < 0)
+	ctx = isl_map_get_ctx(map);
+	space = isl_space_range(isl_map_get_space(map));
+	entry = find_array(data, space, 1);
+	if (!entry)
+		goto error;
+	array = entry->data;
+	if (!array) {
+		array = isl_calloc_type(ctx, struct isl_compute_flow_array);
+		if (!array)
+			goto error;
+		entry->data = array;
+		array->array = isl_space_copy(space);
+		array->source[0] = isl_map_list_alloc(ctx, 0);
+		array->source[1] = isl_map_list_alloc(ctx, 0);
+	}
+	isl_space_free(space);
+	array->source[data->must] =
+		isl_map_list_add(array->source[data->must], map);
+	if (!array->source[data->must])
 		return isl_stat_error;
-	if (eq)
-		data->count++;
 
 	return isl_stat_ok;
+error:
+	isl_space_free(space);
+	isl_map_free(map);
+	return isl_stat_error;
 }
 
-static isl_stat collect_matching_array(__isl_take isl_map *map, void *user)
+static isl_stat free_array(void **entry, void *user)
 {
-	int eq;
-	isl_space *dim;
-	struct isl_sched_info *info;
-	struct isl_compute_flow_data *data;
+	struct isl_compute_flow_array *array = *entry;
 
-	data = (struct isl_compute_flow_data *)user;
+	isl_space_free(array->array);
+	isl_map_list_free(array->source[0]);
+	isl_map_list_free(array->source[1]);
+	free(array);
 
-	dim = isl_space_range(isl_map_get_space(map));
+	return isl_stat_ok;
+}
 
-	eq = isl_space_is_equal(dim, data->dim);
+/* Free the hash table data->arrays along with its entries.
+ */
+static void free_arrays(isl_ctx *ctx, struct isl_compute_flow_data *data)
+{
+	if (!data->arrays)
+		return;
+	isl_hash_table_foreach(ctx, data->arrays, &free_array, NULL);
+	isl_hash_table_free(ctx, data->arrays);
+}
 
-	isl_space_free(dim);
+/* Group the must and may sources in data->must_source and
+ * data->may_source per accessed array in data->arrays.
+ */
+static isl_stat group_sources(isl_ctx *ctx, struct isl_compute_flow_data *data)
+{
+	data->arrays = isl_hash_table_alloc(ctx, 0);
+	if (!data->arrays)
+		return isl_stat_error;
+	data->must = 1;
+	if (isl_union_map_foreach_map(data->must_source,
+					&group_source, data) < 0)
+		return isl_stat_error;
+	data->must = 0;
+	if (isl_union_map_foreach_map(data->may_source,
+					&group_source, data) < 0)
+		return isl_stat_error;
+	return isl_stat_ok;
+}
 
-	if (eq < 0)
-		goto error;
-	if (!eq) {
-		isl_map_free(map);
-		return isl_stat_ok;
-	}
+/* Add the source access "map", which accesses the same array as
+ * the sink, to data->accesses.
+ */
+static isl_stat collect_matching_array(__isl_take isl_map *map, void *user)
+{
+	struct isl_sched_info *info;
+	struct isl_compute_flow_data *data;
+
+	data = (struct isl_compute_flow_data *)user;
 
 	info = sched_info_alloc(map);
 	data->source_info[data->count] = info;
@@ -1880,9 +2142,6 @@ static isl_stat collect_matching_array(__isl_take isl_map *map, void *user)
 	data->count++;
 
 	return isl_stat_ok;
-error:
-	isl_map_free(map);
-	return isl_stat_error;
 }
 
 /* Determine the shared nesting level and the "textual order" of
@@ -1930,8 +2189,8 @@ static int before(void *first, void *second)
 	return 2 * n1;
 }
 
-/* Given a sink access, look for all the source accesses that access
- * the same array and perform dataflow analysis on them using
+/* Given a sink access, look up the source accesses that access
+ * the same array in data->arrays and perform dataflow analysis on them using
  * isl_access_info_compute_flow_core.
  */
 static isl_stat compute_flow(__isl_take isl_map *map, void *user)
@@ -1939,6 +2198,8 @@ static isl_stat compute_flow(__isl_take isl_map *map, void *user)
 	int i;
 	isl_ctx *ctx;
 	struct isl_compute_flow_data *data;
+	struct isl_hash_table_entry *entry;
+	struct isl_compute_flow_array *array;
 	isl_flow *flow;
 	isl_union_flow *df;
 
@@ -1953,12 +2214,13 @@ static isl_stat compute_flow(__isl_take isl_map *map, void *user)
 	data->count = 0;
 	data->dim = isl_space_range(isl_map_get_space(map));
 
-	if (isl_union_map_foreach_map(data->must_source,
-					&count_matching_array, data) < 0)
-		goto error;
-	if (isl_union_map_foreach_map(data->may_source,
-					&count_matching_array, data) < 0)
+	if (!data->dim)
 		goto error;
+	entry = find_array(data, data->dim, 0);
+	array = entry ? entry->data : NULL;
+	if (array)
+		data->count = isl_map_list_n_map(array->source[1]) +
+				isl_map_list_n_map(array->source[0]);
 
 	data->sink_info = sched_info_alloc(map);
 	data->source_info = isl_calloc_array(ctx, struct isl_sched_info *,
@@ -1969,13 +2231,14 @@ static isl_stat compute_flow(__isl_take isl_map *map, void *user)
 	if (!data->sink_info || (data->count && !data->source_info) ||
 	    !data->accesses)
 		goto error;
+	data->accesses->lexmax_cache = data->lexmax_cache;
 	data->count = 0;
 	data->must = 1;
-	if (isl_union_map_foreach_map(data->must_source,
+	if (array && isl_map_list_foreach(array->source[1],
 					&collect_matching_array, data) < 0)
 		goto error;
 	data->must = 0;
-	if (isl_union_map_foreach_map(data->may_source,
+	if (array && isl_map_list_foreach(array->source[0],
 					&collect_matching_array, data) < 0)
 		goto error;
 
@@ -2062,11 +2325,16 @@ static __isl_give isl_union_access_info *isl_union_access_info_normalize(
  *
  * We first prepend the schedule dimensions to the domain
  * of the accesses so that we can easily compare their relative order.
- * Then we consider each sink access individually in compute_flow.
+ * The sources are then grouped per accessed array such that
+ * each sink access can be considered individually in compute_flow
+ * without having to look at the sources that access other arrays.
+ * The analyses of the individual sinks share a cache
+ * of partial lexicographic maxima.
  */
 static __isl_give isl_union_flow *compute_flow_union_map(
 	__isl_take isl_union_access_info *access)
 {
+	isl_ctx *ctx;
 	struct isl_compute_flow_data data;
 
 	access = isl_union_access_info_align_params(access);
@@ -2074,19 +2342,28 @@ static __isl_give isl_union_flow *compute_flow_union_map(
 	if (!access)
 		return NULL;
 
+	ctx = isl_union_access_info_get_ctx(access);
 	data.must_source = access->must_source;
 	data.may_source = access->may_source;
+	data.arrays = NULL;
+	data.lexmax_cache = isl_flow_lexmax_cache_alloc(ctx);
 
 	data.flow = isl_union_flow_alloc(isl_union_map_get_space(access->sink));
 
+	if (!data.lexmax_cache || group_sources(ctx, &data) < 0)
+		goto error;
 	if (isl_union_map_foreach_map(access->sink, &compute_flow, &data) < 0)
 		goto error;
 
 	data.flow = isl_union_flow_drop_schedule(data.flow);
 
+	free_arrays(ctx, &data);
+	isl_flow_lexmax_cache_free(ctx, data.lexmax_cache);
 	isl_union_access_info_free(access);
 	return data.flow;
 error:
+	free_arrays(ctx, &data);
+	isl_flow_lexmax_cache_free(ctx, data.lexmax_cache);
 	isl_union_access_info_free(access);
 	isl_union_flow_free(data.flow);
 	return NULL;
@@ -2114,6 +2391,9 @@ struct isl_scheduled_access {
  * "set_sink", "must" and "node" are only used inside collect_sink_source,
  * to keep track of the current node and
  * of what extract_sink_source needs to do.
+ *
+ * "lexmax_cache" is a cache of partial lexicographic maxima
+ * shared by the analyses of the individual sinks.
  */
 struct isl_compute_flow_schedule_data {
 	isl_union_access_info *access;
@@ -2127,6 +2407,8 @@ struct isl_compute_flow_schedule_data {
 	int set_sink;
 	int must;
 	isl_schedule_node *node;
+
+	struct isl_hash_table *lexmax_cache;
 };
 
 /* Align the parameters of all sinks with all sources.
@@ -2439,6 +2721,8 @@ static __isl_give isl_union_flow *compute_single_flow(
 
 	access = isl_access_info_alloc(isl_map_copy(sink->access), sink->node,
 					&before_node, data->n_source);
+	if (access)
+		access->lexmax_cache = data->lexmax_cache;
 	access = add_matching_sources(access, sink, data);
 
 	flow = access_info_compute_flow_core(access);
@@ -2488,7 +2772,8 @@ static __isl_give isl_union_flow *compute_single_flow(
  *
  * We extract the individual scheduled source and sink access relations
  * (taking into account the domain of the schedule) and
- * then compute dependences for each scheduled sink individually.
+ * then compute dependences for each scheduled sink individually,
+ * sharing a cache of partial lexicographic maxima among them.
  */
 static __isl_give isl_union_flow *compute_flow_schedule(
 	__isl_take isl_union_access_info *access)
@@ -2522,9 +2807,14 @@ static __isl_give isl_union_flow *compute_flow_schedule(
 
 	isl_compute_flow_schedule_data_align_params(&data);
 
+	data.lexmax_cache = isl_flow_lexmax_cache_alloc(ctx);
+	if (!data.lexmax_cache)
+		flow = isl_union_flow_free(flow);
+
 	for (i = 0; i < data.n_sink; ++i)
 		flow = compute_single_flow(flow, &data.sink[i], &data);
 
+	isl_flow_lexmax_cache_free(ctx, data.lexmax_cache);
 	isl_compute_flow_schedule_data_clear(&data);
 
 	isl_union_access_info_free(access);
@@ -2563,6 +2853,207 @@ __isl_give isl_union_flow *isl_union_access_info_compute_flow(
 		return compute_flow_union_map(access);
 }
 
+/* Do "access1" and "access2" have the same schedule?
+ * If one of them has a schedule tree and the other a schedule map,
+ * then they are considered to be different.
+ */
+static isl_bool isl_union_access_info_has_equal_schedule(
+	__isl_keep isl_union_access_info *access1,
+	__isl_keep isl_union_access_info *access2)
+{
+	if (!access1 || !access2)
+		return isl_bool_error;
+	if (access1->schedule && access2->schedule)
+		return isl_schedule_plain_is_equal(access1->schedule,
+						access2->schedule);
+	if (access1->schedule || access2->schedule)
+		return isl_bool_false;
+	return isl_union_map_is_equal(access1->schedule_map,
+					access2->schedule_map);
+}
+
+/* Add the universes of the arrays accessed by accesses that appear
+ * in exactly one of "umap1" and "umap2" to "arrays".
+ */
+static __isl_give isl_union_set *add_changed_arrays(
+	__isl_take isl_union_set *arrays, __isl_keep isl_union_map *umap1,
+	__isl_keep isl_union_map *umap2)
+{
+	isl_union_map *diff1, *diff2;
+
+	diff1 = isl_union_map_subtract(isl_union_map_copy(umap1),
+					isl_union_map_copy(umap2));
+	diff2 = isl_union_map_subtract(isl_union_map_copy(umap2),
+					isl_union_map_copy(umap1));
+	diff1 = isl_union_map_union(diff1, diff2);
+	arrays = isl_union_set_union(arrays,
+			isl_union_set_universe(isl_union_map_range(diff1)));
+
+	return arrays;
+}
+
+/* Return the universes of the arrays for which the accesses
+ * in "access1" and "access2" differ.
+ */
+static __isl_give isl_union_set *changed_arrays(
+	__isl_keep isl_union_access_info *access1,
+	__isl_keep isl_union_access_info *access2)
+{
+	isl_union_set *arrays;
+
+	arrays = isl_union_set_empty(isl_union_map_get_space(access1->sink));
+	arrays = add_changed_arrays(arrays, access1->sink, access2->sink);
+	arrays = add_changed_arrays(arrays, access1->must_source,
+					access2->must_source);
+	arrays = add_changed_arrays(arrays, access1->may_source,
+					access2->may_source);
+
+	return arrays;
+}
+
+/* Only keep the accesses in "access" to elements of "arrays".
+ */
+static __isl_give isl_union_access_info *isl_union_access_info_keep_arrays(
+	__isl_take isl_union_access_info *access,
+	__isl_take isl_union_set *arrays)
+{
+	if (!access || !arrays)
+		goto error;
+
+	access->sink = isl_union_map_intersect_range(access->sink,
+						isl_union_set_copy(arrays));
+	access->must_source = isl_union_map_intersect_range(
+				access->must_source, isl_union_set_copy(arrays));
+	access->may_source = isl_union_map_intersect_range(access->may_source,
+						isl_union_set_copy(arrays));
+	isl_union_set_free(arrays);
+
+	if (!access->sink || !access->must_source || !access->may_source)
+		return isl_union_access_info_free(access);
+
+	return access;
+error:
+	isl_union_access_info_free(access);
+	isl_union_set_free(arrays);
+	return NULL;
+}
+
+/* Remove the parts of "flow" that correspond to sink accesses
+ * in "sink" to elements of "arrays".
+ * The dependences in "flow" are of the form
+ *
+ *	[Source] -> [[Sink -> Data]]
+ *
+ * while the no source relations are subsets of "sink".
+ */
+static __isl_give isl_union_flow *isl_union_flow_drop_arrays(
+	__isl_take isl_union_flow *flow, __isl_keep isl_union_map *sink,
+	__isl_take isl_union_set *arrays)
+{
+	isl_union_map *drop;
+	isl_union_set *wrapped;
+
+	if (!flow)
+		goto error;
+
+	drop = isl_union_map_universe(isl_union_map_copy(sink));
+	drop = isl_union_map_intersect_range(drop, arrays);
+	wrapped = isl_union_map_wrap(isl_union_map_copy(drop));
+	flow->must_dep = isl_union_map_subtract_range(flow->must_dep,
+						isl_union_set_copy(wrapped));
+	flow->may_dep = isl_union_map_subtract_range(flow->may_dep, wrapped);
+	flow->must_no_source = isl_union_map_subtract(flow->must_no_source,
+						isl_union_map_copy(drop));
+	flow->may_no_source = isl_union_map_subtract(flow->may_no_source,
+						drop);
+
+	if (!flow->must_dep || !flow->may_dep ||
+	    !flow->must_no_source || !flow->may_no_source)
+		return isl_union_flow_free(flow);
+
+	return flow;
+error:
+	isl_union_set_free(arrays);
+	return NULL;
+}
+
+/* Combine the results of two dependence analyses on disjoint sets
+ * of sink accesses.
+ */
+static __isl_give isl_union_flow *isl_union_flow_union(
+	__isl_take isl_union_flow *flow1, __isl_take isl_union_flow *flow2)
+{
+	if (!flow1 || !flow2)
+		goto error;
+
+	flow1->must_dep = isl_union_map_union(flow1->must_dep,
+					isl_union_map_copy(flow2->must_dep));
+	flow1->may_dep = isl_union_map_union(flow1->may_dep,
+					isl_union_map_copy(flow2->may_dep));
+	flow1->must_no_source = isl_union_map_union(flow1->must_no_source,
+				isl_union_map_copy(flow2->must_no_source));
+	flow1->may_no_source = isl_union_map_union(flow1->may_no_source,
+				isl_union_map_copy(flow2->may_no_source));
+	isl_union_flow_free(flow2);
+
+	if (!flow1->must_dep || !flow1->may_dep ||
+	    !flow1->must_no_source || !flow1->may_no_source)
+		return isl_union_flow_free(flow1);
+
+	return flow1;
+error:
+	isl_union_flow_free(flow1);
+	isl_union_flow_free(flow2);
+	return NULL;
+}
+
+/* Given the result "prev_flow" of a dependence analysis on "prev_access",
+ * compute the result of the dependence analysis on "access".
+ *
+ * The sinks of each array are analyzed independently of those
+ * of the other arrays and only depend on the sources that access
+ * the same array.  The result for an array therefore only needs
+ * to be recomputed if any of the accesses to that array have changed.
+ * If the schedule has changed, then the entire analysis is performed
+ * on "access".
+ *
+ * Otherwise, the part of "prev_flow" corresponding to the changed arrays
+ * is removed and replaced by the result of the analysis on
+ * the accesses to those arrays in "access".
+ */
+__isl_give isl_union_flow *isl_union_access_info_update_flow(
+	__isl_take isl_union_access_info *access,
+	__isl_take isl_union_access_info *prev_access,
+	__isl_take isl_union_flow *prev_flow)
+{
+	isl_bool equal;
+	isl_union_set *arrays;
+	isl_union_flow *flow;
+
+	equal = isl_union_access_info_has_equal_schedule(access, prev_access);
+	if (equal < 0 || !prev_flow)
+		goto error;
+	if (!equal) {
+		isl_union_access_info_free(prev_access);
+		isl_union_flow_free(prev_flow);
+		return isl_union_access_info_compute_flow(access);
+	}
+
+	arrays = changed_arrays(access, prev_access);
+	prev_flow = isl_union_flow_drop_arrays(prev_flow, prev_access->sink,
+						isl_union_set_copy(arrays));
+	isl_union_access_info_free(prev_access);
+	access = isl_union_access_info_keep_arrays(access, arrays);
+	flow = isl_union_access_info_compute_flow(access);
+
+	return isl_union_flow_union(prev_flow, flow);
+error:
+	isl_union_access_info_free(access);
+	isl_union_access_info_free(prev_access);
+	isl_union_flow_free(prev_flow);
+	return NULL;
+}
+
 /* Print the information contained in "flow" to "p".
  * The information is printed as a YAML document.
  */
@@ -672,6 +672,7 @@ __isl_give isl_qpolynomial_fold *isl_qpolynomial_fold_gist_params(
 #define NO_NEG
 #define NO_SUB
 #define NO_PULLBACK
+#define NO_TRANSFER
 
 #include <isl_pw_templ.c>
 
@@ -190,6 +190,29 @@ __isl_give isl_id *isl_id_set_free_user(__isl_take isl_id *id,
 	return id;
 }
 
+/* Return the isl_id in "ctx" with the same name and user pointer as "id".
+ * If "id" already belongs to "ctx" or if it is a static isl_id,
+ * then it is returned unchanged.
+ * The free_user callback of "id" is not transferred to the result,
+ * i.e., the user pointer remains owned by the original isl_id.
+ */
+__isl_give isl_id *isl_id_transfer(__isl_take isl_id *id, isl_ctx *ctx)
+{
+	isl_id *res;
+
+	if (!id || !ctx)
+		goto error;
+	if (id->ref < 0 || id->ctx == ctx)
+		return id;
+
+	res = isl_id_alloc(ctx, id->name, id->user);
+	isl_id_free(id);
+	return res;
+error:
+	isl_id_free(id);
+	return NULL;
+}
+
 /* If the id has a negative refcount, then it is a static isl_id
  * and should not be freed.
  */
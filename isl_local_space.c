@@ -110,6 +110,28 @@ __isl_give isl_local_space *isl_local_space_dup(__isl_keep isl_local_space *ls)
 
 }
 
+/* Return a copy of "ls" in "ctx".
+ */
+__isl_give isl_local_space *isl_local_space_transfer(
+	__isl_take isl_local_space *ls, isl_ctx *ctx)
+{
+	isl_space *space;
+	isl_mat *div;
+
+	if (!ls || !ctx)
+		goto error;
+	if (isl_local_space_get_ctx(ls) == ctx)
+		return ls;
+
+	space = isl_space_transfer(isl_space_copy(ls->dim), ctx);
+	div = isl_mat_transfer(isl_mat_copy(ls->div), ctx);
+	isl_local_space_free(ls);
+	return isl_local_space_alloc_div(space, div);
+error:
+	isl_local_space_free(ls);
+	return NULL;
+}
+
 __isl_give isl_local_space *isl_local_space_cow(__isl_take isl_local_space *ls)
 {
 	if (!ls)
@@ -18,6 +18,7 @@
 #include <isl_mat_private.h>
 #include <isl_val_private.h>
 #include <isl_vec_private.h>
+#include <isl_constraint_private.h>
 
 enum isl_lp_result isl_tab_solve_lp(struct isl_basic_map *bmap, int maximize,
 				      isl_int *f, isl_int denom, isl_int *opt,
@@ -360,3 +361,258 @@ __isl_give isl_val *isl_basic_set_max_lp_val(__isl_keep isl_basic_set *bset,
 {
 	return isl_basic_set_opt_lp_val(bset, 1, obj);
 }
+
+/* An LP session keeps track of a tableau "tab" for a basic set
+ * with local space "ls" such that several objectives can be
+ * optimized over the same basic set without constructing
+ * a new tableau for each of them.
+ * Since isl_tab_min does not undo the pivots it performs,
+ * each optimization starts from the basis of the previous one.
+ *
+ * "snap" is a stack of "n_snap" snapshots of "tab"
+ * with room for "size_snap" elements.
+ */
+struct isl_lp_session {
+	isl_local_space *ls;
+	struct isl_tab *tab;
+
+	int n_snap;
+	int size_snap;
+	struct isl_tab_undo **snap;
+};
+
+/* Construct an LP session for optimizing objectives over "bset".
+ */
+__isl_give isl_lp_session *isl_lp_session_alloc(
+	__isl_take isl_basic_set *bset)
+{
+	isl_ctx *ctx;
+	isl_lp_session *lp;
+
+	if (!bset)
+		return NULL;
+
+	ctx = isl_basic_set_get_ctx(bset);
+	lp = isl_calloc_type(ctx, struct isl_lp_session);
+	if (!lp)
+		goto error;
+
+	bset = isl_basic_set_gauss(bset, NULL);
+	lp->ls = isl_basic_set_get_local_space(bset);
+	lp->tab = isl_tab_from_basic_set(bset, 0);
+	isl_basic_set_free(bset);
+	if (!lp->ls || !lp->tab)
+		return isl_lp_session_free(lp);
+
+	return lp;
+error:
+	isl_basic_set_free(bset);
+	return NULL;
+}
+
+__isl_null isl_lp_session *isl_lp_session_free(__isl_take isl_lp_session *lp)
+{
+	if (!lp)
+		return NULL;
+
+	isl_local_space_free(lp->ls);
+	isl_tab_free(lp->tab);
+	free(lp->snap);
+	free(lp);
+
+	return NULL;
+}
+
+isl_ctx *isl_lp_session_get_ctx(__isl_keep isl_lp_session *lp)
+{
+	return lp ? isl_local_space_get_ctx(lp->ls) : NULL;
+}
+
+/* Return a copy of the affine expression "row" living in
+ * the local space "ls", expressed in terms of the variables
+ * of the tableau of "lp".
+ * "ls" needs to be equal to the local space of "lp" or
+ * to have the same space and no existentially quantified variables.
+ * In the latter case, the coefficients of the existentially
+ * quantified variables of "lp" are set to zero.
+ */
+static __isl_give isl_vec *extract_row(__isl_keep isl_lp_session *lp,
+	__isl_keep isl_local_space *ls, isl_int *row)
+{
+	isl_ctx *ctx;
+	isl_bool equal;
+	isl_vec *v;
+	unsigned total, n;
+
+	equal = isl_local_space_is_equal(lp->ls, ls);
+	if (equal < 0)
+		return NULL;
+	ctx = isl_local_space_get_ctx(ls);
+	if (!equal && (isl_local_space_dim(ls, isl_dim_div) != 0 ||
+		       !isl_space_is_equal(lp->ls->dim, ls->dim)))
+		isl_die(ctx, isl_error_invalid,
+			"local spaces don't match", return NULL);
+
+	total = isl_local_space_dim(lp->ls, isl_dim_all);
+	n = isl_local_space_dim(ls, isl_dim_all);
+	v = isl_vec_alloc(ctx, 1 + total);
+	if (!v)
+		return NULL;
+	isl_seq_cpy(v->el, row, 1 + n);
+	isl_seq_clr(v->el + 1 + n, total - n);
+
+	return v;
+}
+
+/* Return the optimal (rational) value of "obj" over the basic set of "lp",
+ * taking into account any constraints that have been added since.
+ * If "max" is set, then the maximal value is computed.
+ * Otherwise, the minimal value is computed.
+ *
+ * Return infinity or negative infinity if the optimal value is unbounded and
+ * NaN if the basic set is empty.
+ */
+static __isl_give isl_val *lp_session_opt(__isl_keep isl_lp_session *lp,
+	int max, __isl_keep isl_aff *obj)
+{
+	isl_ctx *ctx;
+	isl_vec *v;
+	isl_val *res;
+	enum isl_lp_result lp_res;
+
+	if (!lp || !obj)
+		return NULL;
+
+	ctx = isl_aff_get_ctx(obj);
+	v = extract_row(lp, obj->ls, obj->v->el + 1);
+	res = isl_val_alloc(ctx);
+	if (!v || !res || isl_tab_extend_cons(lp->tab, 1) < 0)
+		goto error;
+
+	if (max)
+		isl_seq_neg(v->el, v->el, v->size);
+	lp_res = isl_tab_min(lp->tab, v->el, obj->v->el[0],
+				&res->n, &res->d, 0);
+	isl_vec_free(v);
+	if (lp_res == isl_lp_ok) {
+		if (max)
+			isl_int_neg(res->n, res->n);
+		return isl_val_normalize(res);
+	}
+	isl_val_free(res);
+	if (lp_res == isl_lp_error)
+		return NULL;
+	if (lp_res == isl_lp_empty)
+		return isl_val_nan(ctx);
+	if (max)
+		return isl_val_infty(ctx);
+	else
+		return isl_val_neginfty(ctx);
+error:
+	isl_vec_free(v);
+	isl_val_free(res);
+	return NULL;
+}
+
+/* Return the minimal (rational) value of "obj" over the basic set of "lp",
+ * taking into account any constraints that have been added since.
+ *
+ * Return negative infinity if the minimal value is unbounded and
+ * NaN if the basic set is empty.
+ */
+__isl_give isl_val *isl_lp_session_min_val(__isl_keep isl_lp_session *lp,
+	__isl_keep isl_aff *obj)
+{
+	return lp_session_opt(lp, 0, obj);
+}
+
+/* Return the maximal (rational) value of "obj" over the basic set of "lp",
+ * taking into account any constraints that have been added since.
+ *
+ * Return infinity if the maximal value is unbounded and
+ * NaN if the basic set is empty.
+ */
+__isl_give isl_val *isl_lp_session_max_val(__isl_keep isl_lp_session *lp,
+	__isl_keep isl_aff *obj)
+{
+	return lp_session_opt(lp, 1, obj);
+}
+
+/* Add "constraint" to the basic set of "lp".
+ * If the basic set is already known to be empty, then there is no need
+ * to add the constraint.
+ */
+isl_stat isl_lp_session_add_constraint(__isl_keep isl_lp_session *lp,
+	__isl_take isl_constraint *constraint)
+{
+	isl_vec *v;
+	int r;
+
+	if (!lp || !constraint)
+		goto error;
+
+	if (lp->tab->empty) {
+		isl_constraint_free(constraint);
+		return isl_stat_ok;
+	}
+
+	v = extract_row(lp, constraint->ls, constraint->v->el);
+	if (!v || isl_tab_extend_cons(lp->tab, 2) < 0)
+		r = -1;
+	else if (constraint->eq)
+		r = isl_tab_add_eq(lp->tab, v->el);
+	else
+		r = isl_tab_add_ineq(lp->tab, v->el);
+	isl_vec_free(v);
+	isl_constraint_free(constraint);
+
+	return r < 0 ? isl_stat_error : isl_stat_ok;
+error:
+	isl_constraint_free(constraint);
+	return isl_stat_error;
+}
+
+/* Take a snapshot of the current state of "lp" such that
+ * a subsequent call to isl_lp_session_rollback can undo
+ * any constraints added after this call.
+ * Snapshots are kept on a stack.
+ */
+isl_stat isl_lp_session_snapshot(__isl_keep isl_lp_session *lp)
+{
+	if (!lp)
+		return isl_stat_error;
+
+	if (lp->n_snap >= lp->size_snap) {
+		int size = 2 * lp->size_snap + 4;
+		struct isl_tab_undo **snap;
+
+		snap = isl_realloc_array(isl_lp_session_get_ctx(lp), lp->snap,
+					struct isl_tab_undo *, size);
+		if (!snap)
+			return isl_stat_error;
+		lp->snap = snap;
+		lp->size_snap = size;
+	}
+	lp->snap[lp->n_snap++] = isl_tab_snap(lp->tab);
+
+	return isl_stat_ok;
+}
+
+/* Remove all constraints that were added to "lp" since
+ * the most recent snapshot that has not been rolled back yet.
+ * The basis of the tableau is not reset, so subsequent optimizations
+ * still start from the most recently computed optimum.
+ */
+isl_stat isl_lp_session_rollback(__isl_keep isl_lp_session *lp)
+{
+	if (!lp)
+		return isl_stat_error;
+	if (lp->n_snap == 0)
+		isl_die(isl_lp_session_get_ctx(lp), isl_error_invalid,
+			"no snapshot to roll back to", return isl_stat_error);
+
+	if (isl_tab_rollback(lp->tab, lp->snap[--lp->n_snap]) < 0)
+		return isl_stat_error;
+
+	return isl_stat_ok;
+}
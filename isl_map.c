@@ -1126,6 +1126,44 @@ struct isl_basic_set *isl_basic_set_dup(struct isl_basic_set *bset)
 	return (struct isl_basic_set *)dup;
 }
 
+/* Return a copy of "bmap" in "ctx".
+ * The constraints, the flags and the cached sample point (if any)
+ * are copied over.
+ */
+__isl_give isl_basic_map *isl_basic_map_transfer(
+	__isl_take isl_basic_map *bmap, isl_ctx *ctx)
+{
+	isl_space *space;
+	isl_basic_map *dup;
+
+	if (!bmap || !ctx)
+		goto error;
+	if (bmap->ctx == ctx)
+		return bmap;
+
+	space = isl_space_transfer(isl_basic_map_get_space(bmap), ctx);
+	dup = isl_basic_map_alloc_space(space,
+			bmap->n_div, bmap->n_eq, bmap->n_ineq);
+	if (!dup)
+		goto error;
+	dup_constraints(dup, bmap);
+	dup->flags = bmap->flags;
+	dup->sample = isl_vec_transfer(isl_vec_copy(bmap->sample), ctx);
+	isl_basic_map_free(bmap);
+	return dup;
+error:
+	isl_basic_map_free(bmap);
+	return NULL;
+}
+
+/* Return a copy of "bset" in "ctx".
+ */
+__isl_give isl_basic_set *isl_basic_set_transfer(
+	__isl_take isl_basic_set *bset, isl_ctx *ctx)
+{
+	return isl_basic_map_transfer(bset, ctx);
+}
+
 struct isl_basic_set *isl_basic_set_copy(struct isl_basic_set *bset)
 {
 	if (!bset)
@@ -5534,6 +5572,42 @@ struct isl_map *isl_map_dup(struct isl_map *map)
 	return dup;
 }
 
+/* Return a copy of "map" in "ctx".
+ */
+__isl_give isl_map *isl_map_transfer(__isl_take isl_map *map, isl_ctx *ctx)
+{
+	int i;
+	isl_space *space;
+	isl_map *dup;
+
+	if (!map || !ctx)
+		goto error;
+	if (map->ctx == ctx)
+		return map;
+
+	space = isl_space_transfer(isl_map_get_space(map), ctx);
+	dup = isl_map_alloc_space(space, map->n, map->flags);
+	for (i = 0; i < map->n; ++i) {
+		isl_basic_map *bmap;
+
+		bmap = isl_basic_map_copy(map->p[i]);
+		bmap = isl_basic_map_transfer(bmap, ctx);
+		dup = isl_map_add_basic_map(dup, bmap);
+	}
+	isl_map_free(map);
+	return dup;
+error:
+	isl_map_free(map);
+	return NULL;
+}
+
+/* Return a copy of "set" in "ctx".
+ */
+__isl_give isl_set *isl_set_transfer(__isl_take isl_set *set, isl_ctx *ctx)
+{
+	return isl_map_transfer(set, ctx);
+}
+
 __isl_give isl_map *isl_map_add_basic_map(__isl_take isl_map *map,
 						__isl_take isl_basic_map *bmap)
 {
@@ -8103,6 +8177,8 @@ isl_bool isl_basic_map_is_empty(__isl_keep isl_basic_map *bmap)
 	if (!bmap)
 		return isl_bool_error;
 
+	bmap->ctx->stats->emptiness_tests++;
+
 	if (ISL_F_ISSET(bmap, ISL_BASIC_MAP_EMPTY))
 		return isl_bool_true;
 
@@ -9141,7 +9217,7 @@ int isl_basic_map_plain_cmp(const __isl_keep isl_basic_map *bmap1,
 	if (isl_basic_map_n_param(bmap1) != isl_basic_map_n_param(bmap2))
 		return isl_basic_map_n_param(bmap1) - isl_basic_map_n_param(bmap2);
 	if (isl_basic_map_n_in(bmap1) != isl_basic_map_n_in(bmap2))
-		return isl_basic_map_n_out(bmap1) - isl_basic_map_n_out(bmap2);
+		return isl_basic_map_n_in(bmap1) - isl_basic_map_n_in(bmap2);
 	if (isl_basic_map_n_out(bmap1) != isl_basic_map_n_out(bmap2))
 		return isl_basic_map_n_out(bmap1) - isl_basic_map_n_out(bmap2);
 	if (ISL_F_ISSET(bmap1, ISL_BASIC_MAP_EMPTY) &&
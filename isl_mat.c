@@ -218,6 +218,29 @@ struct isl_mat *isl_mat_dup(struct isl_mat *mat)
 	return mat2;
 }
 
+/* Return a copy of "mat" in "ctx".
+ */
+__isl_give isl_mat *isl_mat_transfer(__isl_take isl_mat *mat, isl_ctx *ctx)
+{
+	int i;
+	isl_mat *dup;
+
+	if (!mat || !ctx)
+		goto error;
+	if (mat->ctx == ctx)
+		return mat;
+
+	dup = isl_mat_alloc(ctx, mat->n_row, mat->n_col);
+	if (dup)
+		for (i = 0; i < mat->n_row; ++i)
+			isl_seq_cpy(dup->row[i], mat->row[i], mat->n_col);
+	isl_mat_free(mat);
+	return dup;
+error:
+	isl_mat_free(mat);
+	return NULL;
+}
+
 struct isl_mat *isl_mat_cow(struct isl_mat *mat)
 {
 	struct isl_mat *mat2;
@@ -90,6 +90,36 @@ __isl_give MULTI(BASE) *FN(MULTI(BASE),dup)(__isl_keep MULTI(BASE) *multi)
 	return dup;
 }
 
+/* Return a copy of "multi" in "ctx".
+ */
+__isl_give MULTI(BASE) *FN(MULTI(BASE),transfer)(__isl_take MULTI(BASE) *multi,
+	isl_ctx *ctx)
+{
+	int i;
+	isl_space *space;
+	MULTI(BASE) *res;
+
+	if (!multi || !ctx)
+		goto error;
+	if (FN(MULTI(BASE),get_ctx)(multi) == ctx)
+		return multi;
+
+	space = isl_space_transfer(isl_space_copy(multi->space), ctx);
+	res = FN(MULTI(BASE),alloc)(space);
+	for (i = 0; i < multi->n; ++i) {
+		EL *el;
+
+		el = FN(EL,transfer)(FN(EL,copy)(multi->p[i]), ctx);
+		res = FN(FN(MULTI(BASE),set),BASE)(res, i, el);
+	}
+
+	FN(MULTI(BASE),free)(multi);
+	return res;
+error:
+	FN(MULTI(BASE),free)(multi);
+	return NULL;
+}
+
 __isl_give MULTI(BASE) *FN(MULTI(BASE),cow)(__isl_take MULTI(BASE) *multi)
 {
 	if (!multi)
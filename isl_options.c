@@ -134,6 +134,14 @@ ISL_ARG_CHOICE(struct isl_options, convex, 0, "convex-hull", \
 	convex,	ISL_CONVEX_HULL_WRAP, "convex hull algorithm to use")
 ISL_ARG_BOOL(struct isl_options, coalesce_bounded_wrapping, 0,
 	"coalesce-bounded-wrapping", 1, "bound wrapping during coalescing")
+ISL_ARG_INT(struct isl_options, sample_cache_size, 0,
+	"sample-cache-size", "size", 0, "maximal number of basic sets "
+	"for which the result of an integer sample computation is cached. "
+	"A value of 0 disables the cache.")
+ISL_ARG_INT(struct isl_options, coefficients_cache_size, 0,
+	"coefficients-cache-size", "size", 0, "maximal number of basic sets "
+	"for which the set of coefficients of valid constraints is cached "
+	"across calls. A value of 0 disables the cache.")
 ISL_ARG_INT(struct isl_options, schedule_max_coefficient, 0,
 	"schedule-max-coefficient", "limit", -1, "Only consider schedules "
 	"where the coefficients of the variable and parameter dimensions "
@@ -172,6 +180,13 @@ ISL_ARG_CHOICE(struct isl_options, schedule_algorithm, 0,
 ISL_ARG_BOOL(struct isl_options, schedule_serialize_sccs, 0,
 	"schedule-serialize-sccs", 0,
 	"serialize strongly connected components in dependence graph")
+ISL_ARG_INT(struct isl_options, schedule_max_operations, 0,
+	"schedule-max-operations", "ops", 0, "maximal number of operations "
+	"spent on scheduling a (weakly) connected component before falling "
+	"back to a cheaper strategy.  A value of 0 means no limit.")
+ISL_ARG_BOOL(struct isl_options, schedule_trace, 0,
+	"schedule-trace", 0,
+	"print a trace of the scheduler to standard error")
 ISL_ARG_PHANTOM_USER_CHOICE_F(0, "schedule-fuse", fuse, &set_fuse,
 	ISL_SCHEDULE_FUSE_MAX, "level of fusion during scheduling",
 	ISL_ARG_HIDDEN)
@@ -239,6 +254,16 @@ ISL_CTX_SET_BOOL_DEF(isl_options, struct isl_options, isl_options_args,
 ISL_CTX_GET_BOOL_DEF(isl_options, struct isl_options, isl_options_args,
 	coalesce_bounded_wrapping)
 
+ISL_CTX_SET_INT_DEF(isl_options, struct isl_options, isl_options_args,
+	sample_cache_size)
+ISL_CTX_GET_INT_DEF(isl_options, struct isl_options, isl_options_args,
+	sample_cache_size)
+
+ISL_CTX_SET_INT_DEF(isl_options, struct isl_options, isl_options_args,
+	coefficients_cache_size)
+ISL_CTX_GET_INT_DEF(isl_options, struct isl_options, isl_options_args,
+	coefficients_cache_size)
+
 ISL_CTX_SET_BOOL_DEF(isl_options, struct isl_options, isl_options_args,
 	gbr_only_first)
 ISL_CTX_GET_BOOL_DEF(isl_options, struct isl_options, isl_options_args,
@@ -299,6 +324,16 @@ ISL_CTX_SET_BOOL_DEF(isl_options, struct isl_options, isl_options_args,
 ISL_CTX_GET_BOOL_DEF(isl_options, struct isl_options, isl_options_args,
 	schedule_serialize_sccs)
 
+ISL_CTX_SET_INT_DEF(isl_options, struct isl_options, isl_options_args,
+	schedule_max_operations)
+ISL_CTX_GET_INT_DEF(isl_options, struct isl_options, isl_options_args,
+	schedule_max_operations)
+
+ISL_CTX_SET_BOOL_DEF(isl_options, struct isl_options, isl_options_args,
+	schedule_trace)
+ISL_CTX_GET_BOOL_DEF(isl_options, struct isl_options, isl_options_args,
+	schedule_trace)
+
 ISL_CTX_SET_BOOL_DEF(isl_options, struct isl_options, isl_options_args,
 	tile_scale_tile_loops)
 ISL_CTX_GET_BOOL_DEF(isl_options, struct isl_options, isl_options_args,
@@ -35,6 +35,9 @@ struct isl_options {
 
 	int			coalesce_bounded_wrapping;
 
+	int			sample_cache_size;
+	int			coefficients_cache_size;
+
 	int			schedule_max_coefficient;
 	int			schedule_max_constant_term;
 	int			schedule_parametric;
@@ -47,6 +50,8 @@ struct isl_options {
 	int			schedule_whole_component;
 	unsigned		schedule_algorithm;
 	int			schedule_serialize_sccs;
+	int			schedule_max_operations;
+	int			schedule_trace;
 
 	int			tile_scale_tile_loops;
 	int			tile_shift_point_loops;
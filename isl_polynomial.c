@@ -2887,6 +2887,7 @@ __isl_give isl_pw_qpolynomial *isl_pw_qpolynomial_from_qpolynomial(
 #define DEFAULT_IS_ZERO 1
 
 #define NO_PULLBACK
+#define NO_TRANSFER
 
 #include <isl_pw_templ.c>
 
@@ -846,3 +846,79 @@ __isl_give isl_printer *isl_printer_yaml_next(__isl_take isl_printer *p)
 
 	return p;
 }
+
+/* Print the key "key" and the value "v" of an element in a YAML mapping.
+ * If "first" is not set, then move to the next element first.
+ * In flow style, the key is quoted such that the complete mapping
+ * is also valid JSON.
+ */
+__isl_give isl_printer *isl_printer_yaml_print_long(__isl_take isl_printer *p,
+	const char *key, long v, int first)
+{
+	char buffer[50];
+	int flow;
+
+	if (!p)
+		return NULL;
+	flow = p->yaml_style == ISL_YAML_STYLE_FLOW;
+	if (!first)
+		p = isl_printer_yaml_next(p);
+	if (flow)
+		p = isl_printer_print_str(p, "\"");
+	p = isl_printer_print_str(p, key);
+	if (flow)
+		p = isl_printer_print_str(p, "\"");
+	p = isl_printer_yaml_next(p);
+	snprintf(buffer, sizeof(buffer), "%ld", v);
+	p = isl_printer_print_str(p, buffer);
+
+	return p;
+}
+
+/* Print the statistics "stats" to "p" as a YAML mapping.
+ */
+__isl_give isl_printer *isl_printer_print_stats(__isl_take isl_printer *p,
+	const struct isl_stats *stats)
+{
+	if (!stats)
+		return isl_printer_free(p);
+
+	p = isl_printer_yaml_start_mapping(p);
+	p = isl_printer_yaml_print_long(p, "gbr_solved_lps",
+			stats->gbr_solved_lps, 1);
+	p = isl_printer_yaml_print_long(p, "pivots",
+			stats->pivots, 0);
+	p = isl_printer_yaml_print_long(p, "tableaus",
+			stats->tableaus, 0);
+	p = isl_printer_yaml_print_long(p, "max_tableau_rows",
+			stats->max_tableau_rows, 0);
+	p = isl_printer_yaml_print_long(p, "max_tableau_cols",
+			stats->max_tableau_cols, 0);
+	p = isl_printer_yaml_print_long(p, "emptiness_tests",
+			stats->emptiness_tests, 0);
+	p = isl_printer_yaml_print_long(p, "coalesce_pair_tests",
+			stats->coalesce_pair_tests, 0);
+	p = isl_printer_yaml_print_long(p, "gist_calls",
+			stats->gist_calls, 0);
+	p = isl_printer_yaml_print_long(p, "lexopt_splits",
+			stats->lexopt_splits, 0);
+	p = isl_printer_yaml_print_long(p, "sample_cache_hits",
+			stats->sample_cache_hits, 0);
+	p = isl_printer_yaml_print_long(p, "sample_cache_misses",
+			stats->sample_cache_misses, 0);
+	p = isl_printer_yaml_print_long(p, "coefficients_cache_hits",
+			stats->coefficients_cache_hits, 0);
+	p = isl_printer_yaml_print_long(p, "coefficients_cache_misses",
+			stats->coefficients_cache_misses, 0);
+	p = isl_printer_yaml_print_long(p, "flow_lexmax_cache_hits",
+			stats->flow_lexmax_cache_hits, 0);
+	p = isl_printer_yaml_print_long(p, "flow_lexmax_cache_misses",
+			stats->flow_lexmax_cache_misses, 0);
+	p = isl_printer_yaml_print_long(p, "ast_expr_cache_hits",
+			stats->ast_expr_cache_hits, 0);
+	p = isl_printer_yaml_print_long(p, "ast_expr_cache_misses",
+			stats->ast_expr_cache_misses, 0);
+	p = isl_printer_yaml_end_mapping(p);
+
+	return p;
+}
@@ -48,5 +48,7 @@ struct isl_printer {
 
 __isl_give isl_printer *isl_printer_set_dump(__isl_take isl_printer *p,
 	int dump);
+__isl_give isl_printer *isl_printer_yaml_print_long(__isl_take isl_printer *p,
+	const char *key, long v, int first);
 
 #endif
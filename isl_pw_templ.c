@@ -148,6 +148,43 @@ __isl_give PW *FN(PW,dup)(__isl_keep PW *pw)
 	return dup;
 }
 
+#ifndef NO_TRANSFER
+/* Return a copy of "pw" in "ctx".
+ */
+__isl_give PW *FN(PW,transfer)(__isl_take PW *pw, isl_ctx *ctx)
+{
+	int i;
+	isl_space *space;
+	PW *res;
+
+	if (!pw || !ctx)
+		goto error;
+	if (FN(PW,get_ctx)(pw) == ctx)
+		return pw;
+
+	space = isl_space_transfer(isl_space_copy(pw->dim), ctx);
+#ifdef HAS_TYPE
+	res = FN(PW,alloc_size)(space, pw->type, pw->n);
+#else
+	res = FN(PW,alloc_size)(space, pw->n);
+#endif
+	for (i = 0; i < pw->n; ++i) {
+		isl_set *set;
+		EL *el;
+
+		set = isl_set_transfer(isl_set_copy(pw->p[i].set), ctx);
+		el = FN(EL,transfer)(FN(EL,copy)(pw->p[i].FIELD), ctx);
+		res = FN(PW,add_piece)(res, set, el);
+	}
+
+	FN(PW,free)(pw);
+	return res;
+error:
+	FN(PW,free)(pw);
+	return NULL;
+}
+#endif
+
 __isl_give PW *FN(PW,cow)(__isl_take PW *pw)
 {
 	if (!pw)
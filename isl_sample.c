@@ -1160,9 +1160,375 @@ error:
 	return NULL;
 }
 
+/* An entry in the cache of integer samples.
+ * "hash" is the value of plain_hash on "bset".
+ * "sample" is the result of isl_basic_set_sample_vec on "bset" or
+ * NULL if it has not been computed yet.
+ * "bounded" is the result of isl_basic_set_is_bounded on "bset" or
+ * -1 if it has not been computed yet.
+ * "prev" and "next" link the entry in the list of entries
+ * of the cache, ordered from most to least recently used.
+ */
+struct isl_sample_cache_entry {
+	uint32_t hash;
+	isl_basic_set *bset;
+	isl_vec *sample;
+	int bounded;
+
+	struct isl_sample_cache_entry *prev;
+	struct isl_sample_cache_entry *next;
+};
+
+/* A cache of the results of isl_basic_set_sample_vec and
+ * isl_basic_set_is_bounded, holding at most "size" entries,
+ * "n" of which are in use.
+ * Note that "size" bounds the number of entries and
+ * not the amount of memory used by the cached basic sets.
+ * "table" maps the plain hash of a basic set to its entry.
+ * "head" and "tail" are the most and least recently used entries.
+ * When the cache is full, the least recently used entry is evicted.
+ */
+struct isl_sample_cache {
+	int size;
+	int n;
+	struct isl_hash_table *table;
+	struct isl_sample_cache_entry *head;
+	struct isl_sample_cache_entry *tail;
+};
+
+/* Free "entry" along with the basic set and the sample it holds.
+ */
+static void sample_cache_entry_free(struct isl_sample_cache_entry *entry)
+{
+	isl_basic_set_free(entry->bset);
+	isl_vec_free(entry->sample);
+	free(entry);
+}
+
+/* Free all entries in the sample cache of "ctx" and the cache itself.
+ */
+void isl_sample_cache_clear(isl_ctx *ctx)
+{
+	struct isl_sample_cache *cache;
+	struct isl_sample_cache_entry *entry, *next;
+
+	if (!ctx || !ctx->sample_cache)
+		return;
+
+	cache = ctx->sample_cache;
+	for (entry = cache->head; entry; entry = next) {
+		next = entry->next;
+		sample_cache_entry_free(entry);
+	}
+	isl_hash_table_free(ctx, cache->table);
+	free(cache);
+	ctx->sample_cache = NULL;
+}
+
+/* Return the sample cache of "ctx", holding at most "size" entries,
+ * creating it if needed.
+ * If the size of the cache has changed since it was created,
+ * then the cache is cleared first.
+ */
+static struct isl_sample_cache *get_sample_cache(isl_ctx *ctx, int size)
+{
+	struct isl_sample_cache *cache;
+
+	if (ctx->sample_cache && ctx->sample_cache->size != size)
+		isl_sample_cache_clear(ctx);
+	if (ctx->sample_cache)
+		return ctx->sample_cache;
+
+	cache = isl_calloc_type(ctx, struct isl_sample_cache);
+	if (!cache)
+		return NULL;
+	cache->table = isl_hash_table_alloc(ctx, size);
+	if (!cache->table) {
+		free(cache);
+		return NULL;
+	}
+	cache->size = size;
+	ctx->sample_cache = cache;
+
+	return cache;
+}
+
+/* Compute a hash value of the constraints of "bset", in the order
+ * in which they appear.  Unlike isl_basic_set_get_hash,
+ * this function does not normalize "bset" since that would
+ * involve the removal of redundant constraints, which is about
+ * as expensive as the sample computation itself.
+ */
+static uint32_t plain_hash(__isl_keep isl_basic_set *bset)
+{
+	int i;
+	uint32_t hash = isl_hash_init();
+	unsigned total;
+
+	total = isl_basic_set_total_dim(bset);
+	isl_hash_byte(hash, total & 0xFF);
+	isl_hash_byte(hash, ISL_F_ISSET(bset, ISL_BASIC_SET_RATIONAL) ? 1 : 0);
+	isl_hash_byte(hash, bset->n_eq & 0xFF);
+	for (i = 0; i < bset->n_eq; ++i)
+		isl_hash_hash(hash, isl_seq_get_hash(bset->eq[i], 1 + total));
+	isl_hash_byte(hash, bset->n_ineq & 0xFF);
+	for (i = 0; i < bset->n_ineq; ++i)
+		isl_hash_hash(hash, isl_seq_get_hash(bset->ineq[i], 1 + total));
+
+	return hash;
+}
+
+/* Is the basic set of the cache entry "entry" plainly equal to "val"?
+ */
+static int has_bset(const void *entry, const void *val)
+{
+	const struct isl_sample_cache_entry *cache_entry = entry;
+	isl_basic_set *bset = (isl_basic_set *) val;
+
+	return isl_basic_set_plain_cmp(cache_entry->bset, bset) == 0;
+}
+
+/* Is "entry" equal to "val"?
+ */
+static int is_entry(const void *entry, const void *val)
+{
+	return entry == val;
+}
+
+/* Remove "entry" from the list of entries of "cache".
+ */
+static void sample_cache_unlink(struct isl_sample_cache *cache,
+	struct isl_sample_cache_entry *entry)
+{
+	if (entry->prev)
+		entry->prev->next = entry->next;
+	else
+		cache->head = entry->next;
+	if (entry->next)
+		entry->next->prev = entry->prev;
+	else
+		cache->tail = entry->prev;
+	entry->prev = NULL;
+	entry->next = NULL;
+}
+
+/* Insert "entry" at the front of the list of entries of "cache",
+ * marking it as the most recently used entry.
+ */
+static void sample_cache_push(struct isl_sample_cache *cache,
+	struct isl_sample_cache_entry *entry)
+{
+	entry->prev = NULL;
+	entry->next = cache->head;
+	if (cache->head)
+		cache->head->prev = entry;
+	else
+		cache->tail = entry;
+	cache->head = entry;
+}
+
+/* Look for an entry in "cache" for a basic set that is
+ * plainly equal to "bset", which has plain hash "hash".
+ * Return the entry if one is found and NULL otherwise.
+ * A found entry becomes the most recently used entry.
+ */
+static struct isl_sample_cache_entry *sample_cache_find(isl_ctx *ctx,
+	struct isl_sample_cache *cache, __isl_keep isl_basic_set *bset,
+	uint32_t hash)
+{
+	struct isl_hash_table_entry *table_entry;
+	struct isl_sample_cache_entry *entry;
+
+	table_entry = isl_hash_table_find(ctx, cache->table, hash,
+					&has_bset, bset, 0);
+	if (!table_entry)
+		return NULL;
+
+	entry = table_entry->data;
+	sample_cache_unlink(cache, entry);
+	sample_cache_push(cache, entry);
+	return entry;
+}
+
+/* Remove the least recently used entry from "cache".
+ */
+static void sample_cache_evict(isl_ctx *ctx, struct isl_sample_cache *cache)
+{
+	struct isl_hash_table_entry *table_entry;
+	struct isl_sample_cache_entry *entry = cache->tail;
+
+	table_entry = isl_hash_table_find(ctx, cache->table, entry->hash,
+					&is_entry, entry, 0);
+	if (table_entry)
+		isl_hash_table_remove(ctx, cache->table, table_entry);
+	sample_cache_unlink(cache, entry);
+	sample_cache_entry_free(entry);
+	cache->n--;
+}
+
+/* Return the entry in "cache" for "bset", which has plain hash "hash",
+ * creating an empty entry if there is none.
+ * If the cache is full, then the least recently used entry
+ * is evicted first.
+ */
+static struct isl_sample_cache_entry *sample_cache_insert(isl_ctx *ctx,
+	struct isl_sample_cache *cache, __isl_take isl_basic_set *bset,
+	uint32_t hash)
+{
+	struct isl_hash_table_entry *table_entry;
+	struct isl_sample_cache_entry *entry;
+
+	if (!bset)
+		return NULL;
+
+	entry = sample_cache_find(ctx, cache, bset, hash);
+	if (entry) {
+		isl_basic_set_free(bset);
+		return entry;
+	}
+
+	if (cache->n >= cache->size)
+		sample_cache_evict(ctx, cache);
+
+	entry = isl_calloc_type(ctx, struct isl_sample_cache_entry);
+	if (!entry)
+		goto error;
+	table_entry = isl_hash_table_find(ctx, cache->table, hash,
+					&has_bset, bset, 1);
+	if (!table_entry) {
+		free(entry);
+		goto error;
+	}
+	entry->hash = hash;
+	entry->bset = bset;
+	entry->bounded = -1;
+	table_entry->data = entry;
+	sample_cache_push(cache, entry);
+	cache->n++;
+
+	return entry;
+error:
+	isl_basic_set_free(bset);
+	return NULL;
+}
+
+/* Can the results of computations on "bset" be stored in the sample cache
+ * of "ctx", which should then hold at most "size" entries?
+ * Basic sets with parameters or existentially quantified variables
+ * are not cached since basic_set_sample rejects them.
+ */
+static int is_cacheable(__isl_keep isl_basic_set *bset, int size)
+{
+	return size > 0 && isl_basic_set_n_param(bset) == 0 &&
+		bset->n_div == 0;
+}
+
+/* Compute an integer sample in "bset".
+ *
+ * If the sample-cache-size option is set, then first look
+ * for a basic set with exactly the same constraints in the sample cache
+ * and add the result to this cache if it is not found.
+ * The computation of the sample may itself use the cache and
+ * may therefore evict the entry for "bset", so this entry
+ * is looked up again after the sample has been computed.
+ */
 __isl_give isl_vec *isl_basic_set_sample_vec(__isl_take isl_basic_set *bset)
 {
-	return basic_set_sample(bset, 0);
+	isl_ctx *ctx;
+	int size;
+	uint32_t hash;
+	isl_vec *sample;
+	isl_basic_set *copy;
+	struct isl_sample_cache *cache;
+	struct isl_sample_cache_entry *entry;
+
+	if (!bset)
+		return NULL;
+
+	ctx = isl_basic_set_get_ctx(bset);
+	size = ctx->opt->sample_cache_size;
+	if (size <= 0)
+		isl_sample_cache_clear(ctx);
+	if (!is_cacheable(bset, size))
+		return basic_set_sample(bset, 0);
+
+	cache = get_sample_cache(ctx, size);
+	if (!cache) {
+		isl_basic_set_free(bset);
+		return NULL;
+	}
+
+	hash = plain_hash(bset);
+	entry = sample_cache_find(ctx, cache, bset, hash);
+	if (entry && entry->sample) {
+		ctx->stats->sample_cache_hits++;
+		isl_basic_set_free(bset);
+		return isl_vec_copy(entry->sample);
+	}
+
+	ctx->stats->sample_cache_misses++;
+	copy = isl_basic_set_copy(bset);
+	sample = basic_set_sample(bset, 0);
+	if (!sample) {
+		isl_basic_set_free(copy);
+		return NULL;
+	}
+	entry = sample_cache_insert(ctx, cache, copy, hash);
+	if (!entry)
+		return isl_vec_free(sample);
+	if (!entry->sample)
+		entry->sample = isl_vec_copy(sample);
+
+	return sample;
+}
+
+/* Is "bset" bounded, as computed by "is_bounded"?
+ *
+ * If the sample-cache-size option is set, then first look
+ * for a basic set with exactly the same constraints in the sample cache
+ * and add the result to this cache if it is not found.
+ */
+int isl_basic_set_cached_is_bounded(__isl_keep isl_basic_set *bset,
+	int (*is_bounded)(__isl_keep isl_basic_set *bset))
+{
+	isl_ctx *ctx;
+	int size;
+	int bounded;
+	uint32_t hash;
+	struct isl_sample_cache *cache;
+	struct isl_sample_cache_entry *entry;
+
+	if (!bset)
+		return -1;
+
+	ctx = isl_basic_set_get_ctx(bset);
+	size = ctx->opt->sample_cache_size;
+	if (size <= 0)
+		isl_sample_cache_clear(ctx);
+	if (!is_cacheable(bset, size))
+		return is_bounded(bset);
+
+	cache = get_sample_cache(ctx, size);
+	if (!cache)
+		return -1;
+
+	hash = plain_hash(bset);
+	entry = sample_cache_find(ctx, cache, bset, hash);
+	if (entry && entry->bounded >= 0) {
+		ctx->stats->sample_cache_hits++;
+		return entry->bounded;
+	}
+
+	ctx->stats->sample_cache_misses++;
+	bounded = is_bounded(bset);
+	if (bounded < 0)
+		return -1;
+	entry = sample_cache_insert(ctx, cache, isl_basic_set_copy(bset), hash);
+	if (!entry)
+		return -1;
+	entry->bounded = bounded;
+
+	return bounded;
 }
 
 /* Compute an integer sample in "bset", where the caller guarantees
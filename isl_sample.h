@@ -24,6 +24,10 @@ __isl_give isl_vec *isl_basic_set_sample_with_cone(
 
 __isl_give isl_basic_set *isl_basic_set_from_vec(__isl_take isl_vec *vec);
 
+void isl_sample_cache_clear(isl_ctx *ctx);
+int isl_basic_set_cached_is_bounded(__isl_keep isl_basic_set *bset,
+	int (*is_bounded)(__isl_keep isl_basic_set *bset));
+
 int isl_tab_set_initial_basis_with_cone(struct isl_tab *tab,
 	struct isl_tab *tab_cone);
 struct isl_vec *isl_tab_sample(struct isl_tab *tab);
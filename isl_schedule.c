@@ -124,6 +124,33 @@ __isl_give isl_schedule *isl_schedule_cow(__isl_take isl_schedule *schedule)
 	return isl_schedule_from_schedule_tree(ctx, tree);
 }
 
+/* Return a copy of "schedule" in "ctx".
+ *
+ * We only support this function when the schedule is represented
+ * as a schedule tree.
+ */
+__isl_give isl_schedule *isl_schedule_transfer(
+	__isl_take isl_schedule *schedule, isl_ctx *ctx)
+{
+	isl_schedule_tree *tree;
+
+	if (!schedule || !ctx)
+		goto error;
+	if (isl_schedule_get_ctx(schedule) == ctx)
+		return schedule;
+	if (!schedule->root)
+		isl_die(isl_schedule_get_ctx(schedule), isl_error_internal,
+			"only for schedule tree based schedules", goto error);
+
+	tree = isl_schedule_tree_copy(schedule->root);
+	tree = isl_schedule_tree_transfer(tree, ctx);
+	isl_schedule_free(schedule);
+	return isl_schedule_from_schedule_tree(ctx, tree);
+error:
+	isl_schedule_free(schedule);
+	return NULL;
+}
+
 __isl_null isl_schedule *isl_schedule_free(__isl_take isl_schedule *sched)
 {
 	if (!sched)
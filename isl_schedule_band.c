@@ -74,19 +74,17 @@ error:
 	return NULL;
 }
 
-/* Create a duplicate of the given isl_schedule_band.
+/* Create a duplicate of the given isl_schedule_band in "ctx".
  */
-__isl_give isl_schedule_band *isl_schedule_band_dup(
-	__isl_keep isl_schedule_band *band)
+static __isl_give isl_schedule_band *isl_schedule_band_dup_in(
+	__isl_keep isl_schedule_band *band, isl_ctx *ctx)
 {
 	int i;
-	isl_ctx *ctx;
 	isl_schedule_band *dup;
 
 	if (!band)
 		return NULL;
 
-	ctx = isl_schedule_band_get_ctx(band);
 	dup = isl_schedule_band_alloc(ctx);
 	if (!dup)
 		return NULL;
@@ -101,7 +99,10 @@ __isl_give isl_schedule_band *isl_schedule_band_dup(
 	dup->permutable = band->permutable;
 
 	dup->mupa = isl_multi_union_pw_aff_copy(band->mupa);
+	dup->mupa = isl_multi_union_pw_aff_transfer(dup->mupa, ctx);
 	dup->ast_build_options = isl_union_set_copy(band->ast_build_options);
+	dup->ast_build_options =
+		isl_union_set_transfer(dup->ast_build_options, ctx);
 	if (!dup->mupa || !dup->ast_build_options)
 		return isl_schedule_band_free(dup);
 
@@ -125,6 +126,34 @@ __isl_give isl_schedule_band *isl_schedule_band_dup(
 	return dup;
 }
 
+/* Create a duplicate of the given isl_schedule_band.
+ */
+__isl_give isl_schedule_band *isl_schedule_band_dup(
+	__isl_keep isl_schedule_band *band)
+{
+	return isl_schedule_band_dup_in(band, isl_schedule_band_get_ctx(band));
+}
+
+/* Return a copy of "band" in "ctx".
+ */
+__isl_give isl_schedule_band *isl_schedule_band_transfer(
+	__isl_take isl_schedule_band *band, isl_ctx *ctx)
+{
+	isl_schedule_band *res;
+
+	if (!band || !ctx)
+		goto error;
+	if (isl_schedule_band_get_ctx(band) == ctx)
+		return band;
+
+	res = isl_schedule_band_dup_in(band, ctx);
+	isl_schedule_band_free(band);
+	return res;
+error:
+	isl_schedule_band_free(band);
+	return NULL;
+}
+
 /* Return an isl_schedule_band that is equal to "band" and that has only
  * a single reference.
  */
@@ -59,18 +59,43 @@ static __isl_give isl_schedule_tree *isl_schedule_tree_alloc(isl_ctx *ctx,
 	return tree;
 }
 
-/* Return a fresh copy of "tree".
+/* Return a copy of "list" in "ctx".
  */
-__isl_take isl_schedule_tree *isl_schedule_tree_dup(
-	__isl_keep isl_schedule_tree *tree)
+static __isl_give isl_schedule_tree_list *isl_schedule_tree_list_transfer(
+	__isl_take isl_schedule_tree_list *list, isl_ctx *ctx)
+{
+	int i, n;
+	isl_schedule_tree_list *res;
+
+	if (!list)
+		return NULL;
+	if (isl_schedule_tree_list_get_ctx(list) == ctx)
+		return list;
+
+	n = isl_schedule_tree_list_n_schedule_tree(list);
+	res = isl_schedule_tree_list_alloc(ctx, n);
+	for (i = 0; i < n; ++i) {
+		isl_schedule_tree *tree;
+
+		tree = isl_schedule_tree_list_get_schedule_tree(list, i);
+		tree = isl_schedule_tree_transfer(tree, ctx);
+		res = isl_schedule_tree_list_add(res, tree);
+	}
+
+	isl_schedule_tree_list_free(list);
+	return res;
+}
+
+/* Return a fresh copy of "tree" in "ctx".
+ */
+static __isl_give isl_schedule_tree *isl_schedule_tree_dup_in(
+	__isl_keep isl_schedule_tree *tree, isl_ctx *ctx)
 {
-	isl_ctx *ctx;
 	isl_schedule_tree *dup;
 
 	if (!tree)
 		return NULL;
 
-	ctx = isl_schedule_tree_get_ctx(tree);
 	dup = isl_schedule_tree_alloc(ctx, tree->type);
 	if (!dup)
 		return NULL;
@@ -82,43 +107,53 @@ __isl_take isl_schedule_tree *isl_schedule_tree_dup(
 			isl_schedule_tree_free(dup));
 	case isl_schedule_node_band:
 		dup->band = isl_schedule_band_copy(tree->band);
+		dup->band = isl_schedule_band_transfer(dup->band, ctx);
 		if (!dup->band)
 			return isl_schedule_tree_free(dup);
 		break;
 	case isl_schedule_node_context:
 		dup->context = isl_set_copy(tree->context);
+		dup->context = isl_set_transfer(dup->context, ctx);
 		if (!dup->context)
 			return isl_schedule_tree_free(dup);
 		break;
 	case isl_schedule_node_domain:
 		dup->domain = isl_union_set_copy(tree->domain);
+		dup->domain = isl_union_set_transfer(dup->domain, ctx);
 		if (!dup->domain)
 			return isl_schedule_tree_free(dup);
 		break;
 	case isl_schedule_node_expansion:
 		dup->contraction =
 			isl_union_pw_multi_aff_copy(tree->contraction);
+		dup->contraction =
+			isl_union_pw_multi_aff_transfer(dup->contraction, ctx);
 		dup->expansion = isl_union_map_copy(tree->expansion);
+		dup->expansion = isl_union_map_transfer(dup->expansion, ctx);
 		if (!dup->contraction || !dup->expansion)
 			return isl_schedule_tree_free(dup);
 		break;
 	case isl_schedule_node_extension:
 		dup->extension = isl_union_map_copy(tree->extension);
+		dup->extension = isl_union_map_transfer(dup->extension, ctx);
 		if (!dup->extension)
 			return isl_schedule_tree_free(dup);
 		break;
 	case isl_schedule_node_filter:
 		dup->filter = isl_union_set_copy(tree->filter);
+		dup->filter = isl_union_set_transfer(dup->filter, ctx);
 		if (!dup->filter)
 			return isl_schedule_tree_free(dup);
 		break;
 	case isl_schedule_node_guard:
 		dup->guard = isl_set_copy(tree->guard);
+		dup->guard = isl_set_transfer(dup->guard, ctx);
 		if (!dup->guard)
 			return isl_schedule_tree_free(dup);
 		break;
 	case isl_schedule_node_mark:
 		dup->mark = isl_id_copy(tree->mark);
+		dup->mark = isl_id_transfer(dup->mark, ctx);
 		if (!dup->mark)
 			return isl_schedule_tree_free(dup);
 		break;
@@ -130,6 +165,8 @@ __isl_take isl_schedule_tree *isl_schedule_tree_dup(
 
 	if (tree->children) {
 		dup->children = isl_schedule_tree_list_copy(tree->children);
+		dup->children = isl_schedule_tree_list_transfer(dup->children,
+								ctx);
 		if (!dup->children)
 			return isl_schedule_tree_free(dup);
 	}
@@ -138,6 +175,34 @@ __isl_take isl_schedule_tree *isl_schedule_tree_dup(
 	return dup;
 }
 
+/* Return a fresh copy of "tree".
+ */
+__isl_take isl_schedule_tree *isl_schedule_tree_dup(
+	__isl_keep isl_schedule_tree *tree)
+{
+	return isl_schedule_tree_dup_in(tree, isl_schedule_tree_get_ctx(tree));
+}
+
+/* Return a copy of "tree" in "ctx".
+ */
+__isl_give isl_schedule_tree *isl_schedule_tree_transfer(
+	__isl_take isl_schedule_tree *tree, isl_ctx *ctx)
+{
+	isl_schedule_tree *res;
+
+	if (!tree || !ctx)
+		goto error;
+	if (isl_schedule_tree_get_ctx(tree) == ctx)
+		return tree;
+
+	res = isl_schedule_tree_dup_in(tree, ctx);
+	isl_schedule_tree_free(tree);
+	return res;
+error:
+	isl_schedule_tree_free(tree);
+	return NULL;
+}
+
 /* Return an isl_schedule_tree that is equal to "tree" and that has only
  * a single reference.
  */
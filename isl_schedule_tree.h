@@ -86,6 +86,8 @@ __isl_give isl_schedule_tree *isl_schedule_tree_copy(
 	__isl_keep isl_schedule_tree *tree);
 __isl_null isl_schedule_tree *isl_schedule_tree_free(
 	__isl_take isl_schedule_tree *tree);
+__isl_give isl_schedule_tree *isl_schedule_tree_transfer(
+	__isl_take isl_schedule_tree *tree, isl_ctx *ctx);
 
 __isl_give isl_schedule_tree *isl_schedule_tree_from_band(
 	__isl_take isl_schedule_band *band);
@@ -11,6 +11,8 @@
  * and Ecole Normale Superieure, 45 rue d'Ulm, 75230 Paris, France
  */
 
+#include <time.h>
+
 #include <isl_ctx_private.h>
 #include <isl_map_private.h>
 #include <isl_space_private.h>
@@ -34,6 +36,7 @@
 #include <isl_morph.h>
 #include <isl/ilp.h>
 #include <isl_val_private.h>
+#include <isl_printer_private.h>
 
 /*
  * The scheduling algorithm implemented in this file was inspired by
@@ -58,6 +61,9 @@
  *	the schedule rows
  * cinv is the inverse of cmap.
  * ctrans is the transpose of cmap.
+ * cmap_sched is a private copy of the linear part of sched
+ *	for which rank, cmap, cinv and ctrans were last computed or
+ *	NULL if they have not been computed yet
  * start is the first variable in the LP problem in the sequences that
  *	represents the schedule coefficients of this node
  * nvar is the dimension of the domain
@@ -101,6 +107,7 @@ struct isl_sched_node {
 	isl_mat *cmap;
 	isl_mat *cinv;
 	isl_mat *ctrans;
+	isl_mat *cmap_sched;
 	int	 start;
 	int	 nvar;
 	int	 nparam;
@@ -298,6 +305,8 @@ static int is_conditional_validity(struct isl_sched_edge *edge)
  * band_start is the starting row in the node schedules of the current band
  * root is set if this graph is the original dependence graph,
  *	without any splitting
+ * fallback is set if the schedule should be computed using
+ *	the cheap strategy of compute_schedule_wcc_fallback
  *
  * sorted contains a list of node indices sorted according to the
  *	SCC to which a node belongs
@@ -345,6 +354,7 @@ struct isl_sched_graph {
 	int band_start;
 
 	int root;
+	int fallback;
 
 	struct isl_sched_edge *edge;
 	int n_edge;
@@ -645,6 +655,7 @@ static void graph_free(isl_ctx *ctx, struct isl_sched_graph *graph)
 			isl_mat_free(graph->node[i].cmap);
 			isl_mat_free(graph->node[i].cinv);
 			isl_mat_free(graph->node[i].ctrans);
+			isl_mat_free(graph->node[i].cmap_sched);
 			if (graph->root)
 				free(graph->node[i].coincident);
 			isl_multi_val_free(graph->node[i].sizes);
@@ -1972,14 +1983,33 @@ static int add_all_proximity_constraints(struct isl_sched_graph *graph,
  * computed basis.
  * Similarly, the matrix U is transposed such that we can
  * compute the coefficients c = U s from a schedule row s.
+ *
+ * The decomposition only depends on the linear part of the schedule rows,
+ * so it is not recomputed if this linear part has not changed
+ * since the previous call.
+ * This happens in particular when setup_lp is called again
+ * for the same schedule row after dropping the coincidence constraints.
+ * A copy of the linear part is kept in node->cmap_sched rather than
+ * a reference to node->sched since node->sched may get modified in place.
  */
 static int node_update_cmap(struct isl_sched_node *node)
 {
+	int equal;
 	isl_mat *H, *U, *Q;
 	int n_row = isl_mat_rows(node->sched);
 
 	H = isl_mat_sub_alloc(node->sched, 0, n_row,
 			      1 + node->nparam, node->nvar);
+	if (node->cmap_sched) {
+		equal = isl_mat_is_equal(node->cmap_sched, H);
+		if (equal < 0 || equal) {
+			isl_mat_free(H);
+			return equal < 0 ? -1 : 0;
+		}
+	}
+
+	isl_mat_free(node->cmap_sched);
+	node->cmap_sched = isl_mat_dup(H);
 
 	H = isl_mat_left_hermite(H, 0, &U, &Q);
 	isl_mat_free(node->cmap);
@@ -1991,7 +2021,8 @@ static int node_update_cmap(struct isl_sched_node *node)
 	node->rank = isl_mat_initial_non_zero_cols(H);
 	isl_mat_free(H);
 
-	if (!node->cmap || !node->cinv || !node->ctrans || node->rank < 0)
+	if (!node->cmap_sched ||
+	    !node->cmap || !node->cinv || !node->ctrans || node->rank < 0)
 		return -1;
 	return 0;
 }
@@ -2500,6 +2531,167 @@ static int check_conflict(int con, void *user)
 	return 0;
 }
 
+/* Pass the records of the scheduler trace to "fn" instead of
+ * printing them to standard error.
+ * If "fn" is NULL, then the records are printed to standard error again.
+ * The records are only produced if the schedule_trace option is set.
+ */
+isl_stat isl_ctx_set_schedule_trace_callback(isl_ctx *ctx,
+	void (*fn)(const char *record, void *user), void *user)
+{
+	if (!ctx)
+		return isl_stat_error;
+
+	ctx->schedule_trace = fn;
+	ctx->schedule_trace_user = user;
+
+	return isl_stat_ok;
+}
+
+/* Print the key "key" and the string value "value"
+ * of the current trace record, with the value quoted
+ * such that the record is also valid JSON.
+ * If "first" is not set, then move to the next element first.
+ */
+static __isl_give isl_printer *trace_str(__isl_take isl_printer *p,
+	const char *key, const char *value, int first)
+{
+	if (!p)
+		return NULL;
+
+	if (!first)
+		p = isl_printer_yaml_next(p);
+	p = isl_printer_print_str(p, "\"");
+	p = isl_printer_print_str(p, key);
+	p = isl_printer_print_str(p, "\"");
+	p = isl_printer_yaml_next(p);
+	p = isl_printer_print_str(p, "\"");
+	p = isl_printer_print_str(p, value);
+	p = isl_printer_print_str(p, "\"");
+
+	return p;
+}
+
+/* Start printing a record of type "event" of the scheduler trace,
+ * if the schedule_trace option is set.
+ * Otherwise, return NULL, in which case the other trace functions
+ * do not print anything either.
+ * The record is printed to a string, which is passed on
+ * by trace_end.
+ * The record is printed as a YAML mapping in flow style,
+ * with the keys quoted such that it is also valid JSON.
+ */
+static __isl_give isl_printer *trace_start(isl_ctx *ctx, const char *event)
+{
+	isl_printer *p;
+
+	if (!ctx->opt->schedule_trace)
+		return NULL;
+
+	p = isl_printer_to_str(ctx);
+	p = isl_printer_set_yaml_style(p, ISL_YAML_STYLE_FLOW);
+	p = isl_printer_yaml_start_mapping(p);
+	p = trace_str(p, "event", event, 1);
+
+	return p;
+}
+
+/* Print the key "key" and the value "v" of the current trace record.
+ */
+static __isl_give isl_printer *trace_long(__isl_take isl_printer *p,
+	const char *key, long v)
+{
+	return isl_printer_yaml_print_long(p, key, v, 0);
+}
+
+/* Print the number of nodes and edges in "graph"
+ * as part of the current trace record.
+ */
+static __isl_give isl_printer *trace_graph(__isl_take isl_printer *p,
+	struct isl_sched_graph *graph)
+{
+	p = trace_long(p, "nodes", graph->n);
+	p = trace_long(p, "edges", graph->n_edge);
+
+	return p;
+}
+
+/* Finish printing the current trace record and
+ * pass it to the trace callback of the isl_ctx, if any, or
+ * print it on a separate line to standard error, otherwise.
+ */
+static void trace_end(__isl_take isl_printer *p)
+{
+	isl_ctx *ctx;
+	char *record;
+
+	if (!p)
+		return;
+
+	ctx = isl_printer_get_ctx(p);
+	p = isl_printer_yaml_end_mapping(p);
+	record = isl_printer_get_str(p);
+	isl_printer_free(p);
+	if (!record)
+		return;
+
+	if (ctx->schedule_trace)
+		ctx->schedule_trace(record, ctx->schedule_trace_user);
+	else
+		fprintf(stderr, "%s\n", record);
+	free(record);
+}
+
+/* Information about an (I)LP problem that is being solved,
+ * for the purpose of the scheduler trace.
+ *
+ * "pivots" is the number of pivots performed before the problem
+ * is being solved.
+ * "start" is the processor time at which the solving started.
+ */
+struct isl_sched_trace_lp {
+	long pivots;
+	clock_t start;
+};
+
+/* Record the start of the solution of an (I)LP problem in "t".
+ */
+static void trace_lp_start(isl_ctx *ctx, struct isl_sched_trace_lp *t)
+{
+	if (!ctx->opt->schedule_trace)
+		return;
+
+	t->pivots = ctx->stats->pivots;
+	t->start = clock();
+}
+
+/* Print a trace record for the (I)LP problem graph->lp of kind "kind",
+ * the solution of which was started at "t".
+ */
+static void trace_lp_end(isl_ctx *ctx, const char *kind,
+	struct isl_sched_graph *graph, struct isl_sched_trace_lp *t)
+{
+	isl_printer *p;
+	double time;
+
+	p = trace_start(ctx, "lp");
+	if (!p)
+		return;
+
+	time = (double) (clock() - t->start) * 1000000 / CLOCKS_PER_SEC;
+	p = trace_str(p, "kind", kind, 0);
+	p = trace_graph(p, graph);
+	if (graph->lp) {
+		p = trace_long(p, "variables",
+				isl_basic_set_dim(graph->lp, isl_dim_set));
+		p = trace_long(p, "constraints",
+				graph->lp->n_eq + graph->lp->n_ineq);
+	}
+	p = trace_long(p, "pivots", ctx->stats->pivots - t->pivots);
+	p = trace_long(p, "time_us", (long) time);
+	trace_end(p);
+}
+
 /* Check whether the next schedule row of the given node needs to be
  * non-trivial.  Lower-dimensional domains may have some trivial rows,
  * but as soon as the number of remaining required non-trivial rows
@@ -3035,20 +3227,44 @@ static __isl_give isl_union_set *isl_sched_graph_domain(isl_ctx *ctx,
 
 /* Return a list of unions of universe domains, where each element
  * in the list corresponds to an SCC (or WCC) indexed by node->scc.
+ *
+ * The domains of all components are constructed in a single pass
+ * over the nodes rather than in a pass per component.
+ * The nodes are still added to each domain in the order
+ * in which they appear in "graph".
  */
 static __isl_give isl_union_set_list *extract_sccs(isl_ctx *ctx,
 	struct isl_sched_graph *graph)
 {
 	int i;
+	isl_union_set **dom;
 	isl_union_set_list *filters;
 
+	dom = isl_calloc_array(ctx, isl_union_set *, graph->scc);
+	if (graph->scc && !dom)
+		return NULL;
+
+	for (i = 0; i < graph->n; ++i) {
+		struct isl_sched_node *node = &graph->node[i];
+		isl_union_set *dom_i;
+
+		dom_i = isl_union_set_from_set(
+			    isl_set_universe(isl_space_copy(node->space)));
+		if (!dom[node->scc])
+			dom[node->scc] = dom_i;
+		else
+			dom[node->scc] = isl_union_set_union(dom[node->scc],
+								dom_i);
+	}
+
 	filters = isl_union_set_list_alloc(ctx, graph->scc);
 	for (i = 0; i < graph->scc; ++i) {
-		isl_union_set *dom;
-
-		dom = isl_sched_graph_domain(ctx, graph, &node_scc_exactly, i);
-		filters = isl_union_set_list_add(filters, dom);
+		if (!dom[i])
+			isl_die(ctx, isl_error_internal, "empty component",
+				filters = isl_union_set_list_free(filters));
+		filters = isl_union_set_list_add(filters, dom[i]);
 	}
+	free(dom);
 
 	return filters;
 }
@@ -3073,6 +3289,38 @@ static __isl_give isl_union_set_list *extract_split(isl_ctx *ctx,
 	return filters;
 }
 
+/* Copy the node "node" of a dependence graph to the next position
+ * in the dst dependence graph.
+ */
+static int copy_node(struct isl_sched_graph *dst, struct isl_sched_node *node)
+{
+	int j;
+
+	j = dst->n;
+	dst->node[j].space = isl_space_copy(node->space);
+	dst->node[j].compressed = node->compressed;
+	dst->node[j].hull = isl_set_copy(node->hull);
+	dst->node[j].compress = isl_multi_aff_copy(node->compress);
+	dst->node[j].decompress = isl_multi_aff_copy(node->decompress);
+	dst->node[j].nvar = node->nvar;
+	dst->node[j].nparam = node->nparam;
+	dst->node[j].sched = isl_mat_copy(node->sched);
+	dst->node[j].sched_map = isl_map_copy(node->sched_map);
+	dst->node[j].coincident = node->coincident;
+	dst->node[j].sizes = isl_multi_val_copy(node->sizes);
+	dst->node[j].max = isl_vec_copy(node->max);
+	dst->n++;
+
+	if (!dst->node[j].space || !dst->node[j].sched)
+		return -1;
+	if (dst->node[j].compressed &&
+	    (!dst->node[j].hull || !dst->node[j].compress ||
+	     !dst->node[j].decompress))
+		return -1;
+
+	return 0;
+}
+
 /* Copy nodes that satisfy node_pred from the src dependence graph
  * to the dst dependence graph.
  */
@@ -3083,101 +3331,86 @@ static int copy_nodes(struct isl_sched_graph *dst, struct isl_sched_graph *src,
 
 	dst->n = 0;
 	for (i = 0; i < src->n; ++i) {
-		int j;
-
 		if (!node_pred(&src->node[i], data))
 			continue;
-
-		j = dst->n;
-		dst->node[j].space = isl_space_copy(src->node[i].space);
-		dst->node[j].compressed = src->node[i].compressed;
-		dst->node[j].hull = isl_set_copy(src->node[i].hull);
-		dst->node[j].compress =
-			isl_multi_aff_copy(src->node[i].compress);
-		dst->node[j].decompress =
-			isl_multi_aff_copy(src->node[i].decompress);
-		dst->node[j].nvar = src->node[i].nvar;
-		dst->node[j].nparam = src->node[i].nparam;
-		dst->node[j].sched = isl_mat_copy(src->node[i].sched);
-		dst->node[j].sched_map = isl_map_copy(src->node[i].sched_map);
-		dst->node[j].coincident = src->node[i].coincident;
-		dst->node[j].sizes = isl_multi_val_copy(src->node[i].sizes);
-		dst->node[j].max = isl_vec_copy(src->node[i].max);
-		dst->n++;
-
-		if (!dst->node[j].space || !dst->node[j].sched)
-			return -1;
-		if (dst->node[j].compressed &&
-		    (!dst->node[j].hull || !dst->node[j].compress ||
-		     !dst->node[j].decompress))
+		if (copy_node(dst, &src->node[i]) < 0)
 			return -1;
 	}
 
 	return 0;
 }
 
-/* Copy non-empty edges that satisfy edge_pred from the src dependence graph
- * to the dst dependence graph.
+/* Copy the edge "edge" of the src dependence graph to the dst
+ * dependence graph, provided it is not empty.
  * If the source or destination node of the edge is not in the destination
  * graph, then it must be a backward proximity edge and it should simply
  * be ignored.
  */
-static int copy_edges(isl_ctx *ctx, struct isl_sched_graph *dst,
-	struct isl_sched_graph *src,
-	int (*edge_pred)(struct isl_sched_edge *edge, int data), int data)
+static int copy_edge(isl_ctx *ctx, struct isl_sched_graph *dst,
+	struct isl_sched_graph *src, struct isl_sched_edge *edge)
 {
-	int i;
+	isl_map *map;
+	isl_union_map *tagged_condition;
+	isl_union_map *tagged_validity;
+	struct isl_sched_node *dst_src, *dst_dst;
 	enum isl_edge_type t;
 
-	dst->n_edge = 0;
-	for (i = 0; i < src->n_edge; ++i) {
-		struct isl_sched_edge *edge = &src->edge[i];
-		isl_map *map;
-		isl_union_map *tagged_condition;
-		isl_union_map *tagged_validity;
-		struct isl_sched_node *dst_src, *dst_dst;
+	if (isl_map_plain_is_empty(edge->map))
+		return 0;
 
-		if (!edge_pred(edge, data))
-			continue;
+	dst_src = graph_find_node(ctx, dst, edge->src->space);
+	dst_dst = graph_find_node(ctx, dst, edge->dst->space);
+	if (!dst_src || !dst_dst) {
+		if (is_validity(edge) || is_conditional_validity(edge))
+			isl_die(ctx, isl_error_internal,
+				"backward (conditional) validity edge",
+				return -1);
+		return 0;
+	}
 
-		if (isl_map_plain_is_empty(edge->map))
-			continue;
+	map = isl_map_copy(edge->map);
+	tagged_condition = isl_union_map_copy(edge->tagged_condition);
+	tagged_validity = isl_union_map_copy(edge->tagged_validity);
+
+	dst->edge[dst->n_edge].src = dst_src;
+	dst->edge[dst->n_edge].dst = dst_dst;
+	dst->edge[dst->n_edge].map = map;
+	dst->edge[dst->n_edge].tagged_condition = tagged_condition;
+	dst->edge[dst->n_edge].tagged_validity = tagged_validity;
+	dst->edge[dst->n_edge].types = edge->types;
+	dst->n_edge++;
+
+	if (edge->tagged_condition && !tagged_condition)
+		return -1;
+	if (edge->tagged_validity && !tagged_validity)
+		return -1;
 
-		dst_src = graph_find_node(ctx, dst, edge->src->space);
-		dst_dst = graph_find_node(ctx, dst, edge->dst->space);
-		if (!dst_src || !dst_dst) {
-			if (is_validity(edge) || is_conditional_validity(edge))
-				isl_die(ctx, isl_error_internal,
-					"backward (conditional) validity edge",
-					return -1);
+	for (t = isl_edge_first; t <= isl_edge_last; ++t) {
+		if (edge != graph_find_edge(src, t, edge->src, edge->dst))
 			continue;
-		}
+		if (graph_edge_table_add(ctx, dst, t,
+				    &dst->edge[dst->n_edge - 1]) < 0)
+			return -1;
+	}
 
-		map = isl_map_copy(edge->map);
-		tagged_condition = isl_union_map_copy(edge->tagged_condition);
-		tagged_validity = isl_union_map_copy(edge->tagged_validity);
+	return 0;
+}
 
-		dst->edge[dst->n_edge].src = dst_src;
-		dst->edge[dst->n_edge].dst = dst_dst;
-		dst->edge[dst->n_edge].map = map;
-		dst->edge[dst->n_edge].tagged_condition = tagged_condition;
-		dst->edge[dst->n_edge].tagged_validity = tagged_validity;
-		dst->edge[dst->n_edge].types = edge->types;
-		dst->n_edge++;
+/* Copy non-empty edges that satisfy edge_pred from the src dependence graph
+ * to the dst dependence graph.
+ */
+static int copy_edges(isl_ctx *ctx, struct isl_sched_graph *dst,
+	struct isl_sched_graph *src,
+	int (*edge_pred)(struct isl_sched_edge *edge, int data), int data)
+{
+	int i;
 
-		if (edge->tagged_condition && !tagged_condition)
-			return -1;
-		if (edge->tagged_validity && !tagged_validity)
+	dst->n_edge = 0;
+	for (i = 0; i < src->n_edge; ++i) {
+		if (!edge_pred(&src->edge[i], data))
+			continue;
+		if (copy_edge(ctx, dst, src, &src->edge[i]) < 0)
 			return -1;
-
-		for (t = isl_edge_first; t <= isl_edge_last; ++t) {
-			if (edge !=
-			    graph_find_edge(src, t, edge->src, edge->dst))
-				continue;
-			if (graph_edge_table_add(ctx, dst, t,
-					    &dst->edge[dst->n_edge - 1]) < 0)
-				return -1;
-		}
 	}
 
 	return 0;
@@ -3209,6 +3442,30 @@ static int compute_maxvar(struct isl_sched_graph *graph)
 	return 0;
 }
 
+/* Initialize the edge tables of the subgraph "sub" of "graph",
+ * after its nodes have been copied, and copy the information
+ * about the schedule rows from "graph".
+ */
+static int init_sub_graph(isl_ctx *ctx, struct isl_sched_graph *graph,
+	struct isl_sched_graph *sub)
+{
+	int t;
+
+	if (graph_init_table(ctx, sub) < 0)
+		return -1;
+	for (t = 0; t <= isl_edge_last; ++t)
+		sub->max_edge[t] = graph->max_edge[t];
+	if (graph_init_edge_tables(ctx, sub) < 0)
+		return -1;
+	sub->n_row = graph->n_row;
+	sub->max_row = graph->max_row;
+	sub->n_total_row = graph->n_total_row;
+	sub->band_start = graph->band_start;
+	sub->fallback = graph->fallback;
+
+	return 0;
+}
+
 /* Extract the subgraph of "graph" that consists of the node satisfying
  * "node_pred" and the edges satisfying "edge_pred" and store
  * the result in "sub".
@@ -3219,7 +3476,6 @@ static int extract_sub_graph(isl_ctx *ctx, struct isl_sched_graph *graph,
 	int data, struct isl_sched_graph *sub)
 {
 	int i, n = 0, n_edge = 0;
-	int t;
 
 	for (i = 0; i < graph->n; ++i)
 		if (node_pred(&graph->node[i], data))
@@ -3231,18 +3487,121 @@ static int extract_sub_graph(isl_ctx *ctx, struct isl_sched_graph *graph,
 		return -1;
 	if (copy_nodes(sub, graph, node_pred, data) < 0)
 		return -1;
-	if (graph_init_table(ctx, sub) < 0)
-		return -1;
-	for (t = 0; t <= isl_edge_last; ++t)
-		sub->max_edge[t] = graph->max_edge[t];
-	if (graph_init_edge_tables(ctx, sub) < 0)
+	if (init_sub_graph(ctx, graph, sub) < 0)
 		return -1;
 	if (copy_edges(ctx, sub, graph, edge_pred, data) < 0)
 		return -1;
-	sub->n_row = graph->n_row;
-	sub->max_row = graph->max_row;
-	sub->n_total_row = graph->n_total_row;
-	sub->band_start = graph->band_start;
+
+	return 0;
+}
+
+/* The nodes and edges of a dependence graph, grouped per component,
+ * i.e., per value of node->scc.
+ * The indices of the nodes of component c are stored in
+ * node[node_start[c]] up to (but not including) node[node_start[c + 1]]
+ * and similarly for the indices of the edges,
+ * where an edge belongs to component c if both its source and
+ * its destination belong to component c.
+ * The indices in each component are sorted in increasing order.
+ */
+struct isl_sched_components {
+	int *node_start;
+	int *node;
+	int *edge_start;
+	int *edge;
+};
+
+/* Free the memory allocated by "components".
+ */
+static void isl_sched_components_clear(struct isl_sched_components *components)
+{
+	free(components->node_start);
+	free(components->node);
+	free(components->edge_start);
+	free(components->edge);
+}
+
+/* Group the nodes and edges of "graph" per component and
+ * store the result in "components".
+ * The grouping is performed using a counting sort, which
+ * is linear in the size of the graph and the number of components.
+ */
+static int isl_sched_components_init(isl_ctx *ctx,
+	struct isl_sched_graph *graph, struct isl_sched_components *components)
+{
+	int i;
+	int *pos;
+
+	components->node_start = isl_calloc_array(ctx, int, graph->scc + 1);
+	components->node = isl_alloc_array(ctx, int, graph->n);
+	components->edge_start = isl_calloc_array(ctx, int, graph->scc + 1);
+	components->edge = isl_alloc_array(ctx, int, graph->n_edge);
+	pos = isl_alloc_array(ctx, int, graph->scc);
+	if (!components->node_start || (graph->n && !components->node) ||
+	    !components->edge_start ||
+	    (graph->n_edge && !components->edge) || (graph->scc && !pos)) {
+		free(pos);
+		return -1;
+	}
+
+	for (i = 0; i < graph->n; ++i)
+		components->node_start[graph->node[i].scc + 1]++;
+	for (i = 0; i < graph->n_edge; ++i) {
+		struct isl_sched_edge *edge = &graph->edge[i];
+		if (edge->src->scc == edge->dst->scc)
+			components->edge_start[edge->src->scc + 1]++;
+	}
+	for (i = 0; i < graph->scc; ++i) {
+		components->node_start[i + 1] += components->node_start[i];
+		components->edge_start[i + 1] += components->edge_start[i];
+	}
+
+	for (i = 0; i < graph->scc; ++i)
+		pos[i] = components->node_start[i];
+	for (i = 0; i < graph->n; ++i)
+		components->node[pos[graph->node[i].scc]++] = i;
+	for (i = 0; i < graph->scc; ++i)
+		pos[i] = components->edge_start[i];
+	for (i = 0; i < graph->n_edge; ++i) {
+		struct isl_sched_edge *edge = &graph->edge[i];
+		if (edge->src->scc == edge->dst->scc)
+			components->edge[pos[edge->src->scc]++] = i;
+	}
+
+	free(pos);
+	return 0;
+}
+
+/* Extract the subgraph of "graph" that consists of the nodes and edges
+ * of component "c" in "components" and store the result in "sub".
+ * The result is the same as that of extract_sub_graph
+ * with node_scc_exactly and edge_scc_exactly, but only the nodes and
+ * edges of the component are visited.
+ */
+static int extract_component(isl_ctx *ctx, struct isl_sched_graph *graph,
+	struct isl_sched_components *components, int c,
+	struct isl_sched_graph *sub)
+{
+	int i;
+	int n, n_edge;
+
+	n = components->node_start[c + 1] - components->node_start[c];
+	n_edge = components->edge_start[c + 1] - components->edge_start[c];
+	if (graph_alloc(ctx, sub, n, n_edge) < 0)
+		return -1;
+	sub->n = 0;
+	for (i = components->node_start[c];
+	     i < components->node_start[c + 1]; ++i)
+		if (copy_node(sub, &graph->node[components->node[i]]) < 0)
+			return -1;
+	if (init_sub_graph(ctx, graph, sub) < 0)
+		return -1;
+	sub->n_edge = 0;
+	for (i = components->edge_start[c];
+	     i < components->edge_start[c + 1]; ++i)
+		if (copy_edge(ctx, sub, graph,
+				&graph->edge[components->edge[i]]) < 0)
+			return -1;
 
 	return 0;
 }
@@ -3288,6 +3647,131 @@ error:
 	return isl_schedule_node_free(node);
 }
 
+/* Compute a schedule for the connected component "c" in "components"
+ * of "graph" using a cheap strategy and insert it at "node".
+ * In particular, only compute schedule rows that carry dependences,
+ * as explained in compute_schedule_wcc_fallback.
+ * Mark the result as having been computed using this fallback strategy.
+ */
+static __isl_give isl_schedule_node *compute_component_fallback(
+	__isl_take isl_schedule_node *node, isl_ctx *ctx,
+	struct isl_sched_graph *graph,
+	struct isl_sched_components *components, int c)
+{
+	struct isl_sched_graph split = { 0 };
+
+	if (extract_component(ctx, graph, components, c, &split) < 0) {
+		graph_free(ctx, &split);
+		return isl_schedule_node_free(node);
+	}
+
+	split.fallback = 1;
+	node = compute_schedule_wcc(node, &split);
+
+	graph_free(ctx, &split);
+
+	return isl_schedule_node_insert_mark(node,
+		    isl_id_alloc(ctx, "schedule_budget_exceeded", NULL));
+}
+
+/* Compute a schedule for the connected component "c" in "components"
+ * of "graph" and insert it at "node", within the per-component
+ * operation budget set by the schedule_max_operations option, if any.
+ * There is no per-component budget if the schedule is being computed
+ * using the fallback strategy, since this strategy is not expected
+ * to exceed the budget by a large amount.
+ *
+ * The budget is imposed through the soft limit on the number
+ * of operations of "ctx", which is not reported as an error
+ * when it is reached, and which is set to allow at most
+ * the budget of operations for this component.
+ * Any other error, including reaching the global limit on the number
+ * of operations, is reported at the place where it occurs.
+ * The schedule is computed on a fresh copy of the component
+ * such that the component can be extracted again in its original state
+ * if the budget is exceeded.
+ * If the budget is exceeded, then the error is cleared and a schedule
+ * is computed using a cheap strategy in compute_component_fallback instead.
+ */
+static __isl_give isl_schedule_node *compute_component_wcc(
+	__isl_take isl_schedule_node *node, isl_ctx *ctx,
+	struct isl_sched_graph *graph,
+	struct isl_sched_components *components, int c)
+{
+	int budget;
+	unsigned long soft_max;
+	isl_schedule_node *res;
+	struct isl_sched_graph split = { 0 };
+
+	if (!node)
+		return NULL;
+	if (extract_component(ctx, graph, components, c, &split) < 0)
+		goto error;
+
+	budget = isl_options_get_schedule_max_operations(ctx);
+	if (budget <= 0 || graph->fallback) {
+		node = compute_schedule_wcc(node, &split);
+		graph_free(ctx, &split);
+		return node;
+	}
+
+	soft_max = ctx->soft_max_operations;
+	ctx->soft_max_operations = ctx->operations + budget;
+	res = compute_schedule_wcc(isl_schedule_node_copy(node), &split);
+	ctx->soft_max_operations = soft_max;
+	graph_free(ctx, &split);
+
+	if (res) {
+		isl_schedule_node_free(node);
+		return res;
+	}
+	if (isl_ctx_last_error(ctx) != isl_error_quota ||
+	    (ctx->max_operations && ctx->operations >= ctx->max_operations))
+		return isl_schedule_node_free(node);
+
+	isl_ctx_reset_error(ctx);
+	return compute_component_fallback(node, ctx, graph, components, c);
+error:
+	graph_free(ctx, &split);
+	return isl_schedule_node_free(node);
+}
+
+/* Compute a schedule for the subgraph of "graph" that consists
+ * of component "c" in "components", i.e., the nodes with node->scc
+ * equal to "c" and the edges between them.
+ * This has the same effect as calling compute_sub_schedule
+ * with node_scc_exactly and edge_scc_exactly.
+ * If "wcc" is set, then the component is a weakly connected component
+ * and it is handled by compute_component_wcc, which takes care
+ * of the per-component operation budget.
+ *
+ * The schedule is inserted at "node" and the updated schedule node
+ * is returned.
+ */
+static __isl_give isl_schedule_node *compute_component_sub_schedule(
+	__isl_take isl_schedule_node *node, isl_ctx *ctx,
+	struct isl_sched_graph *graph,
+	struct isl_sched_components *components, int c, int wcc)
+{
+	struct isl_sched_graph split = { 0 };
+
+	if (!node)
+		return NULL;
+	if (wcc)
+		return compute_component_wcc(node, ctx, graph, components, c);
+
+	if (extract_component(ctx, graph, components, c, &split) < 0)
+		goto error;
+
+	node = compute_schedule(node, &split);
+
+	graph_free(ctx, &split);
+	return node;
+error:
+	graph_free(ctx, &split);
+	return isl_schedule_node_free(node);
+}
+
 static int edge_scc_exactly(struct isl_sched_edge *edge, int scc)
 {
 	return edge->src->scc == scc && edge->dst->scc == scc;
@@ -3399,6 +3883,7 @@ static __isl_give isl_schedule_node *insert_current_band(
 {
 	int i;
 	int start, end, n;
+	isl_printer *p;
 	isl_multi_aff *ma;
 	isl_multi_pw_aff *mpa;
 	isl_multi_union_pw_aff *mupa;
@@ -3415,6 +3900,12 @@ static __isl_give isl_schedule_node *insert_current_band(
 	end = graph->n_total_row;
 	n = end - start;
 
+	p = trace_start(isl_schedule_node_get_ctx(node), "band");
+	p = trace_graph(p, graph);
+	p = trace_long(p, "rows", n);
+	p = trace_long(p, "permutable", permutable);
+	trace_end(p);
+
 	ma = node_extract_partial_schedule_multi_aff(&graph->node[0], start, n);
 	mpa = isl_multi_pw_aff_from_multi_aff(ma);
 	mupa = isl_multi_union_pw_aff_from_multi_pw_aff(mpa);
@@ -4125,6 +4616,8 @@ static __isl_give isl_schedule_node *carry_dependences(
 	isl_ctx *ctx;
 	isl_vec *sol;
 	isl_basic_set *lp;
+	isl_printer *p;
+	struct isl_sched_trace_lp t;
 
 	if (!node)
 		return NULL;
@@ -4134,11 +4627,16 @@ static __isl_give isl_schedule_node *carry_dependences(
 		n_edge += graph->edge[i].map->n;
 
 	ctx = isl_schedule_node_get_ctx(node);
+	p = trace_start(ctx, "carry");
+	p = trace_graph(p, graph);
+	trace_end(p);
 	if (setup_carry_lp(ctx, graph) < 0)
 		return isl_schedule_node_free(node);
 
+	trace_lp_start(ctx, &t);
 	lp = isl_basic_set_copy(graph->lp);
 	sol = non_neg_lexmin(graph, lp, n_edge);
+	trace_lp_end(ctx, "carry", graph, &t);
 	if (!sol)
 		return isl_schedule_node_free(node);
 
@@ -4261,6 +4759,35 @@ static __isl_give isl_schedule_node *compute_schedule_wcc_feautrier(
 	return carry_dependences(node, graph);
 }
 
+/* Compute a schedule for a connected dependence graph using
+ * a cheap strategy and return the updated schedule node.
+ * This strategy is used for components that exceed their operation budget.
+ *
+ * As long as there are any validity dependences left, compute
+ * a schedule row that carries as many of them as possible
+ * using carry_dependences.
+ * Each such row is obtained from a single rational LP problem and
+ * carries at least one of the remaining dependences.
+ * In particular, unlike Feautrier's algorithm in
+ * compute_schedule_wcc_feautrier, the schedule is not extended
+ * to a full-dimensional schedule using the ILP based scheduler
+ * once all validity dependences have been carried.
+ * Instead, the remaining statement instances are left unordered.
+ */
+static __isl_give isl_schedule_node *compute_schedule_wcc_fallback(
+	isl_schedule_node *node, struct isl_sched_graph *graph)
+{
+	int has_validity;
+
+	has_validity = has_validity_edges(graph);
+	if (has_validity < 0)
+		return isl_schedule_node_free(node);
+	if (!has_validity)
+		return node;
+
+	return carry_dependences(node, graph);
+}
+
 /* Turn off the "local" bit on all (condition) edges.
  */
 static void clear_local_edges(struct isl_sched_graph *graph)
@@ -4570,13 +5097,16 @@ static isl_stat compute_schedule_wcc_band(isl_ctx *ctx,
 		isl_vec *sol;
 		int violated;
 		int coincident;
+		struct isl_sched_trace_lp t;
 
 		graph->src_scc = -1;
 		graph->dst_scc = -1;
 
 		if (setup_lp(ctx, graph, use_coincidence) < 0)
 			return isl_stat_error;
+		trace_lp_start(ctx, &t);
 		sol = solve_lp(graph);
+		trace_lp_end(ctx, "band", graph, &t);
 		if (!sol)
 			return isl_stat_error;
 		if (sol->size == 0) {
@@ -5742,6 +6272,7 @@ static isl_bool try_merge(isl_ctx *ctx, struct isl_sched_graph *graph,
 {
 	struct isl_sched_graph merge_graph = { 0 };
 	isl_bool merged;
+	isl_printer *p;
 
 	if (init_merge_graph(ctx, graph, c, &merge_graph) < 0)
 		goto error;
@@ -5756,6 +6287,11 @@ static isl_bool try_merge(isl_ctx *ctx, struct isl_sched_graph *graph,
 	if (merged && merge(ctx, c, &merge_graph) < 0)
 		goto error;
 
+	p = trace_start(ctx, "merge");
+	p = trace_graph(p, &merge_graph);
+	p = trace_long(p, "merged", merged);
+	trace_end(p);
+
 	graph_free(ctx, &merge_graph);
 	return merged;
 error:
@@ -6128,6 +6664,9 @@ error:
 /* Compute a schedule for a connected dependence graph and return
  * the updated schedule node.
  *
+ * If the graph is being scheduled using the fallback strategy,
+ * then only compute rows that carry dependences
+ * in compute_schedule_wcc_fallback.
  * If Feautrier's algorithm is selected, we first recursively try to satisfy
  * as many validity dependences as possible. When all validity dependences
  * are satisfied we extend the schedule to a full-dimensional schedule.
@@ -6155,6 +6694,8 @@ static __isl_give isl_schedule_node *compute_schedule_wcc(
 	if (compute_maxvar(graph) < 0)
 		return isl_schedule_node_free(node);
 
+	if (graph->fallback)
+		return compute_schedule_wcc_fallback(node, graph);
 	if (need_feautrier_step(ctx, graph))
 		return compute_schedule_wcc_feautrier(node, graph);
 
@@ -6173,6 +6714,10 @@ static __isl_give isl_schedule_node *compute_schedule_wcc(
  * weakly connected component in the dependence graph so that
  * there is no need for compute_sub_schedule to look for weakly
  * connected components.
+ *
+ * The nodes and edges are grouped per component up front such that
+ * extracting the subgraph of a component only needs to visit
+ * the nodes and edges of that component.
  */
 static __isl_give isl_schedule_node *compute_component_schedule(
 	__isl_take isl_schedule_node *node, struct isl_sched_graph *graph,
@@ -6181,6 +6726,7 @@ static __isl_give isl_schedule_node *compute_component_schedule(
 	int component;
 	isl_ctx *ctx;
 	isl_union_set_list *filters;
+	struct isl_sched_components components = { 0 };
 
 	if (!node)
 		return NULL;
@@ -6192,16 +6738,40 @@ static __isl_give isl_schedule_node *compute_component_schedule(
 	else
 		node = isl_schedule_node_insert_sequence(node, filters);
 
+	if (isl_sched_components_init(ctx, graph, &components) < 0) {
+		isl_sched_components_clear(&components);
+		return isl_schedule_node_free(node);
+	}
+
 	for (component = 0; component < graph->scc; ++component) {
 		node = isl_schedule_node_child(node, component);
 		node = isl_schedule_node_child(node, 0);
-		node = compute_sub_schedule(node, ctx, graph,
-				    &node_scc_exactly,
-				    &edge_scc_exactly, component, wcc);
+		node = compute_component_sub_schedule(node, ctx, graph,
+					&components, component, wcc);
 		node = isl_schedule_node_parent(node);
 		node = isl_schedule_node_parent(node);
 	}
 
+	isl_sched_components_clear(&components);
+	return node;
+}
+
+/* Compute a schedule for the root dependence graph "graph",
+ * which consists of a single weakly connected component,
+ * within the per-component operation budget and insert it at "node".
+ */
+static __isl_give isl_schedule_node *compute_root_wcc(
+	__isl_take isl_schedule_node *node, isl_ctx *ctx,
+	struct isl_sched_graph *graph)
+{
+	struct isl_sched_components components = { 0 };
+
+	if (isl_sched_components_init(ctx, graph, &components) < 0)
+		node = isl_schedule_node_free(node);
+	else
+		node = compute_component_wcc(node, ctx, graph, &components, 0);
+	isl_sched_components_clear(&components);
+
 	return node;
 }
 
@@ -6214,6 +6784,9 @@ static __isl_give isl_schedule_node *compute_component_schedule(
  * If the schedule_serialize_sccs option is set, then we check for strongly
  * connected components instead and compute a separate schedule for
  * each such strongly connected component.
+ * If there is only a single component and a per-component
+ * operation budget has been set, then the budget is also imposed
+ * on the root graph.
  */
 static __isl_give isl_schedule_node *compute_schedule(isl_schedule_node *node,
 	struct isl_sched_graph *graph)
@@ -6234,6 +6807,8 @@ static __isl_give isl_schedule_node *compute_schedule(isl_schedule_node *node,
 
 	if (graph->scc > 1)
 		return compute_component_schedule(node, graph, 1);
+	if (graph->root && isl_options_get_schedule_max_operations(ctx) > 0)
+		return compute_root_wcc(node, ctx, graph);
 
 	return compute_schedule_wcc(node, graph);
 }
@@ -6286,6 +6861,221 @@ __isl_give isl_schedule *isl_schedule_constraints_compute_schedule(
 	return sched;
 }
 
+/* Return the union of the universes of the spaces of the nodes
+ * in (weakly) connected component "wcc" of "graph".
+ */
+static __isl_give isl_union_set *component_universe(
+	struct isl_sched_graph *graph, int wcc)
+{
+	int i;
+	isl_ctx *ctx;
+	isl_union_set *universe;
+
+	ctx = isl_space_get_ctx(graph->node[0].space);
+	universe = isl_union_set_empty(isl_space_params_alloc(ctx, 0));
+	for (i = 0; i < graph->n; ++i) {
+		isl_set *set;
+
+		if (graph->node[i].scc != wcc)
+			continue;
+		set = isl_set_universe(isl_space_copy(graph->node[i].space));
+		universe = isl_union_set_add_set(universe, set);
+	}
+
+	return universe;
+}
+
+/* Return the part of "umap" that involves instances in "universe",
+ * i.e., the pairs of instances of which at least one
+ * lives in "universe".
+ */
+static __isl_give isl_union_map *involving(__isl_take isl_union_map *umap,
+	__isl_keep isl_union_set *universe)
+{
+	isl_union_map *range;
+
+	range = isl_union_map_copy(umap);
+	range = isl_union_map_intersect_range(range,
+					isl_union_set_copy(universe));
+	umap = isl_union_map_intersect_domain(umap,
+					isl_union_set_copy(universe));
+
+	return isl_union_map_union(umap, range);
+}
+
+/* Do "sc" and "prev_sc" impose the same schedule constraints
+ * on the instances in "universe"?
+ * That is, do they have the same domain on "universe" and
+ * are the constraints of each type that involve instances in "universe"
+ * the same?
+ * Constraints that connect instances in "universe" to other instances
+ * are also taken into account such that a change in the partition
+ * into components is also detected.
+ */
+static isl_bool has_equal_constraints_on(
+	__isl_keep isl_schedule_constraints *sc,
+	__isl_keep isl_schedule_constraints *prev_sc,
+	__isl_keep isl_union_set *universe)
+{
+	enum isl_edge_type t;
+	isl_union_set *domain, *prev_domain;
+	isl_bool equal;
+
+	domain = isl_schedule_constraints_get_domain(sc);
+	domain = isl_union_set_intersect(domain,
+					isl_union_set_copy(universe));
+	prev_domain = isl_schedule_constraints_get_domain(prev_sc);
+	prev_domain = isl_union_set_intersect(prev_domain,
+					isl_union_set_copy(universe));
+	equal = isl_union_set_is_equal(domain, prev_domain);
+	isl_union_set_free(domain);
+	isl_union_set_free(prev_domain);
+
+	for (t = isl_edge_first; equal == isl_bool_true &&
+	     t <= isl_edge_last; ++t) {
+		isl_union_map *c, *prev_c;
+
+		c = involving(isl_schedule_constraints_get(sc, t), universe);
+		prev_c = involving(isl_schedule_constraints_get(prev_sc, t),
+					universe);
+		equal = isl_union_map_is_equal(c, prev_c);
+		isl_union_map_free(c);
+		isl_union_map_free(prev_c);
+	}
+
+	return equal;
+}
+
+/* Collect the instances of the (weakly) connected components of "graph"
+ * on which the schedule constraints "sc" from which "graph" was
+ * constructed are the same as the schedule constraints "prev_sc".
+ */
+static __isl_give isl_union_set *collect_unchanged(
+	struct isl_sched_graph *graph,
+	__isl_keep isl_schedule_constraints *sc,
+	__isl_keep isl_schedule_constraints *prev_sc)
+{
+	int wcc;
+	isl_union_set *domain, *unchanged;
+
+	domain = isl_schedule_constraints_get_domain(sc);
+	unchanged = isl_union_set_empty(isl_union_set_get_space(domain));
+	for (wcc = 0; wcc < graph->scc; ++wcc) {
+		isl_union_set *universe;
+		isl_bool equal;
+
+		universe = component_universe(graph, wcc);
+		equal = has_equal_constraints_on(sc, prev_sc, universe);
+		if (equal < 0)
+			unchanged = isl_union_set_free(unchanged);
+		if (equal > 0)
+			unchanged = isl_union_set_union(unchanged,
+				isl_union_set_intersect(
+					isl_union_set_copy(domain), universe));
+		else
+			isl_union_set_free(universe);
+		if (!unchanged)
+			break;
+	}
+	isl_union_set_free(domain);
+
+	return unchanged;
+}
+
+/* Given the schedule "prev" computed from the schedule constraints
+ * "prev_sc", compute a schedule on sc->domain that respects
+ * the schedule constraints "sc", reusing the parts of "prev"
+ * that are not affected by the changes from "prev_sc" to "sc".
+ *
+ * The domain is split into the weakly connected components of
+ * the dependence graph of "sc".  Since there are no constraints between
+ * instances in different components, the schedule of each component
+ * can be computed independently.
+ * The previous schedule is kept for those components on which
+ * "sc" and "prev_sc" have the same domain and the same constraints
+ * of each type, i.e., for the components that were not affected
+ * by any changes to the schedule constraints.
+ * If the context has changed, then all components are affected.
+ * A schedule is only computed for the remaining components and
+ * the result is combined with the reused part of "prev"
+ * in a set node.
+ * Note that the properties of the bands in the reused part,
+ * in particular their coincidence, are taken over from "prev".
+ */
+__isl_give isl_schedule *isl_schedule_constraints_update_schedule(
+	__isl_take isl_schedule_constraints *sc,
+	__isl_take isl_schedule_constraints *prev_sc,
+	__isl_take isl_schedule *prev)
+{
+	isl_ctx *ctx;
+	struct isl_sched_graph graph = { 0 };
+	isl_union_set *domain, *reuse;
+	isl_set *context, *prev_context;
+	isl_schedule *sched;
+	isl_bool empty, equal;
+
+	sc = isl_schedule_constraints_align_params(sc);
+	if (!sc || !prev_sc || !prev)
+		goto error;
+
+	context = isl_schedule_constraints_get_context(sc);
+	prev_context = isl_schedule_constraints_get_context(prev_sc);
+	equal = isl_set_is_equal(context, prev_context);
+	isl_set_free(context);
+	isl_set_free(prev_context);
+	if (equal < 0)
+		goto error;
+
+	ctx = isl_schedule_constraints_get_ctx(sc);
+	domain = isl_schedule_constraints_get_domain(sc);
+	if (!equal || isl_union_set_n_set(domain) == 0) {
+		isl_union_set_free(domain);
+		isl_schedule_constraints_free(prev_sc);
+		isl_schedule_free(prev);
+		return isl_schedule_constraints_compute_schedule(sc);
+	}
+
+	reuse = NULL;
+	if (graph_init(&graph, sc) >= 0 && detect_wccs(ctx, &graph) >= 0)
+		reuse = collect_unchanged(&graph, sc, prev_sc);
+	graph_free(ctx, &graph);
+	isl_schedule_constraints_free(prev_sc);
+
+	empty = isl_union_set_is_empty(reuse);
+	if (empty < 0 || empty) {
+		isl_union_set_free(domain);
+		isl_union_set_free(reuse);
+		isl_schedule_free(prev);
+		if (empty < 0) {
+			isl_schedule_constraints_free(sc);
+			return NULL;
+		}
+		return isl_schedule_constraints_compute_schedule(sc);
+	}
+
+	domain = isl_union_set_subtract(domain, isl_union_set_copy(reuse));
+	prev = isl_schedule_intersect_domain(prev, reuse);
+	empty = isl_union_set_is_empty(domain);
+	if (empty < 0 || empty) {
+		isl_union_set_free(domain);
+		isl_schedule_constraints_free(sc);
+		if (empty < 0)
+			return isl_schedule_free(prev);
+		return prev;
+	}
+
+	sc = isl_schedule_constraints_apply(sc,
+					isl_union_set_identity(domain));
+	sched = isl_schedule_constraints_compute_schedule(sc);
+
+	return isl_schedule_set(prev, sched);
+error:
+	isl_schedule_constraints_free(sc);
+	isl_schedule_constraints_free(prev_sc);
+	isl_schedule_free(prev);
+	return NULL;
+}
+
 /* Compute a schedule for the given union of domains that respects
  * all the validity dependences and minimizes
  * the dependence distances over the proximity dependences.
@@ -45,18 +45,30 @@ void isl_seq_cpy(isl_int *dst, isl_int *src, unsigned len)
 		isl_int_set(dst[i], src[i]);
 }
 
+/* Subtract "f" times "src" from "dst".
+ * Constraint rows are typically sparse, so skip the zero elements
+ * of "src", for which the update is a no-op.
+ */
 void isl_seq_submul(isl_int *dst, isl_int f, isl_int *src, unsigned len)
 {
 	int i;
-	for (i = 0; i < len; ++i)
+	for (i = 0; i < len; ++i) {
+		if (isl_int_is_zero(src[i]))
+			continue;
 		isl_int_submul(dst[i], f, src[i]);
+	}
 }
 
+/* Add "f" times "src" to "dst", skipping the zero elements of "src".
+ */
 void isl_seq_addmul(isl_int *dst, isl_int f, isl_int *src, unsigned len)
 {
 	int i;
-	for (i = 0; i < len; ++i)
+	for (i = 0; i < len; ++i) {
+		if (isl_int_is_zero(src[i]))
+			continue;
 		isl_int_addmul(dst[i], f, src[i]);
+	}
 }
 
 void isl_seq_swp_or_cpy(isl_int *dst, isl_int *src, unsigned len)
@@ -101,6 +113,13 @@ void isl_seq_fdiv_r(isl_int *dst, isl_int *src, isl_int m, unsigned len)
 		isl_int_fdiv_r(dst[i], src[i], m);
 }
 
+/* Set "dst" to "m1" times "src1" plus "m2" times "src2".
+ *
+ * If "dst" is the same as "src1" (as in isl_seq_elim) and
+ * different from "src2", then the result can be computed in place,
+ * without going through a temporary.
+ * The zero elements of "src2" can then also be skipped.
+ */
 void isl_seq_combine(isl_int *dst, isl_int m1, isl_int *src1,
 			isl_int m2, isl_int *src2, unsigned len)
 {
@@ -110,8 +129,17 @@ void isl_seq_combine(isl_int *dst, isl_int m1, isl_int *src1,
 	if (dst == src1 && isl_int_is_one(m1)) {
 		if (isl_int_is_zero(m2))
 			return;
-		for (i = 0; i < len; ++i)
-			isl_int_addmul(src1[i], m2, src2[i]);
+		isl_seq_addmul(dst, m2, src2, len);
+		return;
+	}
+
+	if (dst == src1 && dst != src2) {
+		for (i = 0; i < len; ++i) {
+			isl_int_mul(dst[i], dst[i], m1);
+			if (isl_int_is_zero(src2[i]))
+				continue;
+			isl_int_addmul(dst[i], m2, src2[i]);
+		}
 		return;
 	}
 
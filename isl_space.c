@@ -318,6 +318,63 @@ error:
 	return NULL;
 }
 
+/* Return a copy of "space" in "ctx".
+ * The identifiers are replaced by the corresponding identifiers in "ctx".
+ */
+__isl_give isl_space *isl_space_transfer(__isl_take isl_space *space,
+	isl_ctx *ctx)
+{
+	int i;
+	isl_space *dup;
+
+	if (!space || !ctx)
+		goto error;
+	if (space->ctx == ctx)
+		return space;
+
+	dup = isl_space_alloc(ctx, space->nparam, space->n_in, space->n_out);
+	if (!dup)
+		goto error;
+	for (i = 0; i < 2; ++i) {
+		if (space->tuple_id[i]) {
+			dup->tuple_id[i] = isl_id_copy(space->tuple_id[i]);
+			dup->tuple_id[i] = isl_id_transfer(dup->tuple_id[i],
+							    ctx);
+			if (!dup->tuple_id[i])
+				goto error_dup;
+		}
+		if (space->nested[i]) {
+			dup->nested[i] = isl_space_copy(space->nested[i]);
+			dup->nested[i] = isl_space_transfer(dup->nested[i],
+							    ctx);
+			if (!dup->nested[i])
+				goto error_dup;
+		}
+	}
+	if (space->n_id > 0) {
+		dup->ids = isl_calloc_array(ctx, isl_id *, space->n_id);
+		if (!dup->ids)
+			goto error_dup;
+		dup->n_id = space->n_id;
+	}
+	for (i = 0; i < space->n_id; ++i) {
+		if (!space->ids[i])
+			continue;
+		dup->ids[i] = isl_id_copy(space->ids[i]);
+		dup->ids[i] = isl_id_transfer(dup->ids[i], ctx);
+		if (!dup->ids[i])
+			goto error_dup;
+	}
+
+	isl_space_free(space);
+	return dup;
+error_dup:
+	isl_space_free(dup);
+error:
+	isl_space_free(space);
+	return NULL;
+}
+
 __isl_give isl_space *isl_space_cow(__isl_take isl_space *dim)
 {
 	if (!dim)
@@ -36,6 +36,11 @@ struct isl_tab *isl_tab_alloc(struct isl_ctx *ctx,
 	tab = isl_calloc_type(ctx, struct isl_tab);
 	if (!tab)
 		return NULL;
+	ctx->stats->tableaus++;
+	if (n_row > ctx->stats->max_tableau_rows)
+		ctx->stats->max_tableau_rows = n_row;
+	if (n_var > ctx->stats->max_tableau_cols)
+		ctx->stats->max_tableau_cols = n_var;
 	tab->mat = isl_mat_alloc(ctx, n_row, off + n_var);
 	if (!tab->mat)
 		goto error;
@@ -213,6 +218,7 @@ void isl_tab_free(struct isl_tab *tab)
 	isl_mat_free(tab->samples);
 	free(tab->sample_index);
 	isl_mat_free(tab->basis);
+	free(tab->pivot_nz);
 	free(tab);
 }
 
@@ -1055,6 +1061,137 @@ static void update_row_sign(struct isl_tab *tab, int row, int col, int row_sgn)
 	}
 }
 
+/* Make sure tab->pivot_nz has room for the positions of all entries
+ * in a row of the tableau, other than the denominator.
+ */
+static int ensure_pivot_nz(struct isl_tab *tab)
+{
+	int n;
+	int *nz;
+	unsigned off = 2 + tab->M;
+
+	n = off - 1 + tab->n_col;
+	if (tab->max_pivot_nz >= n)
+		return 0;
+
+	nz = isl_realloc_array(tab->mat->ctx, tab->pivot_nz, int, n);
+	if (!nz)
+		return -1;
+	tab->pivot_nz = nz;
+	tab->max_pivot_nz = n;
+
+	return 0;
+}
+
+/* Collect the positions of the non-zero entries in row "row"
+ * of the tableau, other than the denominator and the entry
+ * in column "col", in tab->pivot_nz and return the number of
+ * such entries.
+ *
+ * Rows of tableaus derived from large sparse problems, such as
+ * the LP problems constructed by the scheduler, typically have
+ * only a few non-zero entries, so the pivot only needs to update
+ * the corresponding entries in the other rows.
+ */
+static int collect_pivot_non_zero(struct isl_tab *tab, int row, int col)
+{
+	int j, n_nz;
+	isl_int *r = tab->mat->row[row];
+	unsigned off = 2 + tab->M;
+
+	n_nz = 0;
+	for (j = 1; j < off + tab->n_col; ++j) {
+		if (j == off + col)
+			continue;
+		if (isl_int_is_zero(r[j]))
+			continue;
+		tab->pivot_nz[n_nz++] = j;
+	}
+
+	return n_nz;
+}
+
+/* Update all rows other than "row" for a pivot on row "row"
+ * and column "col", where the pivot row has already been
+ * transformed into
+ *
+ *	s(n_rc)d_r/|n_rc|	-s(n_rc)n_ri/|n_rc|
+ *
+ * See isl_tab_pivot for the details of the transformation.
+ * The positions of the "n_nz" non-zero entries n_ri
+ * are stored in tab->pivot_nz.
+ * All other entries n_ji only need to be multiplied by |n_rc|.
+ */
+static void pivot_other_rows(struct isl_tab *tab, int row, int col, int n_nz)
+{
+	int i, j;
+	struct isl_mat *mat = tab->mat;
+	unsigned off = 2 + tab->M;
+
+	for (i = 0; i < tab->n_row; ++i) {
+		if (i == row)
+			continue;
+		if (isl_int_is_zero(mat->row[i][off + col]))
+			continue;
+		isl_int_mul(mat->row[i][0], mat->row[i][0], mat->row[row][0]);
+		for (j = 0; j < off - 1 + tab->n_col; ++j) {
+			if (j == off - 1 + col)
+				continue;
+			isl_int_mul(mat->row[i][1 + j],
+				    mat->row[i][1 + j], mat->row[row][0]);
+		}
+		for (j = 0; j < n_nz; ++j) {
+			int pos = tab->pivot_nz[j];
+			isl_int_addmul(mat->row[i][pos],
+				    mat->row[i][off + col], mat->row[row][pos]);
+		}
+		isl_int_mul(mat->row[i][off + col],
+			    mat->row[i][off + col], mat->row[row][off + col]);
+		if (!isl_int_is_one(mat->row[i][0]))
+			isl_seq_normalize(mat->ctx, mat->row[i], off + tab->n_col);
+	}
+}
+
+/* Update all rows other than "row" for a pivot on row "row"
+ * and column "col", as in pivot_other_rows, in the special case
+ * where the transformed pivot row has a unit denominator,
+ * i.e., where |n_rc| = 1 after normalization.
+ * This is by far the most common case.
+ * Multiplying the other rows by |n_rc| is then a no-op, so the update
+ * reduces to
+ *
+ *	n_jc/d_j -> s(n_rc)d_r n_jc/d_j
+ *	n_ji/d_j -> (n_ji - s(n_rc)n_jc n_ri)/d_j
+ *
+ * where the pivot row already holds s(n_rc)d_r and -s(n_rc)n_ri.
+ * The denominators d_j are not affected and
+ * only the entries in the positions of the "n_nz" non-zero entries
+ * of the pivot row, stored in tab->pivot_nz, need to be updated.
+ */
+static void pivot_other_rows_unit(struct isl_tab *tab, int row, int col,
+	int n_nz)
+{
+	int i, j;
+	struct isl_mat *mat = tab->mat;
+	unsigned off = 2 + tab->M;
+
+	for (i = 0; i < tab->n_row; ++i) {
+		if (i == row)
+			continue;
+		if (isl_int_is_zero(mat->row[i][off + col]))
+			continue;
+		for (j = 0; j < n_nz; ++j) {
+			int pos = tab->pivot_nz[j];
+			isl_int_addmul(mat->row[i][pos],
+				    mat->row[i][off + col], mat->row[row][pos]);
+		}
+		isl_int_mul(mat->row[i][off + col],
+			    mat->row[i][off + col], mat->row[row][off + col]);
+		if (!isl_int_is_one(mat->row[i][0]))
+			isl_seq_normalize(mat->ctx, mat->row[i], off + tab->n_col);
+	}
+}
+
 /* Given a row number "row" and a column number "col", pivot the tableau
  * such that the associated variables are interchanged.
  * The given row in the tableau expresses
@@ -1108,6 +1245,7 @@ static void update_row_sign(struct isl_tab *tab, int row, int col, int row_sgn)
 int isl_tab_pivot(struct isl_tab *tab, int row, int col)
 {
 	int i, j;
+	int n_nz;
 	int sgn;
 	int t;
 	isl_ctx *ctx;
@@ -1118,6 +1256,9 @@ int isl_tab_pivot(struct isl_tab *tab, int row, int col)
 	ctx = isl_tab_get_ctx(tab);
 	if (isl_ctx_next_operation(ctx) < 0)
 		return -1;
+	if (ensure_pivot_nz(tab) < 0)
+		return -1;
+	ctx->stats->pivots++;
 
 	isl_int_swap(mat->row[row][0], mat->row[row][off + col]);
 	sgn = isl_int_sgn(mat->row[row][0]);
@@ -1132,25 +1273,11 @@ int isl_tab_pivot(struct isl_tab *tab, int row, int col)
 		}
 	if (!isl_int_is_one(mat->row[row][0]))
 		isl_seq_normalize(mat->ctx, mat->row[row], off + tab->n_col);
-	for (i = 0; i < tab->n_row; ++i) {
-		if (i == row)
-			continue;
-		if (isl_int_is_zero(mat->row[i][off + col]))
-			continue;
-		isl_int_mul(mat->row[i][0], mat->row[i][0], mat->row[row][0]);
-		for (j = 0; j < off - 1 + tab->n_col; ++j) {
-			if (j == off - 1 + col)
-				continue;
-			isl_int_mul(mat->row[i][1 + j],
-				    mat->row[i][1 + j], mat->row[row][0]);
-			isl_int_addmul(mat->row[i][1 + j],
-				    mat->row[i][off + col], mat->row[row][1 + j]);
-		}
-		isl_int_mul(mat->row[i][off + col],
-			    mat->row[i][off + col], mat->row[row][off + col]);
-		if (!isl_int_is_one(mat->row[i][0]))
-			isl_seq_normalize(mat->ctx, mat->row[i], off + tab->n_col);
-	}
+	n_nz = collect_pivot_non_zero(tab, row, col);
+	if (isl_int_is_one(mat->row[row][0]))
+		pivot_other_rows_unit(tab, row, col, n_nz);
+	else
+		pivot_other_rows(tab, row, col, n_nz);
 	t = tab->row_var[row];
 	tab->row_var[row] = tab->col_var[col];
 	tab->col_var[col] = t;
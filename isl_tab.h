@@ -124,6 +124,10 @@ struct isl_tab_undo {
  *
  * If "preserve" is set, then we want to keep all constraints in the
  * tableau, even if they turn out to be redundant.
+ *
+ * "pivot_nz" is scratch space of size "max_pivot_nz" that is used
+ * by isl_tab_pivot to keep track of the positions of the non-zero
+ * entries in the pivot row.
  */
 enum isl_tab_row_sign {
 	isl_tab_row_unknown = 0,
@@ -170,6 +174,9 @@ struct isl_tab {
 	int (*conflict)(int con, void *user);
 	void *conflict_user;
 
+	int *pivot_nz;
+	int max_pivot_nz;
+
 	unsigned strict_redundant : 1;
 	unsigned need_undo : 1;
 	unsigned preserve : 1;
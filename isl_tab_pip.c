@@ -3906,6 +3906,7 @@ static void find_solutions(struct isl_sol *sol, struct isl_tab *tab)
 			continue;
 		if (split != -1) {
 			struct isl_vec *ineq;
+			isl_tab_get_ctx(tab)->stats->lexopt_splits++;
 			if (n_split != 1)
 				split = context->op->best_split(context, tab);
 			if (split < 0)
@@ -36,6 +36,7 @@
 #include <isl/ast_build.h>
 #include <isl/val.h>
 #include <isl/ilp.h>
+#include <isl/lp.h>
 #include <isl_ast_build_expr.h>
 #include <isl/options.h>
 
@@ -1867,6 +1868,11 @@ struct {
 	       "[x, y] : 0 <= x <= 10 and 1 <= y <= 10 }" },
 	{ 1, "{ [a] : a <= 8 and "
 			"(a mod 10 = 7 or a mod 10 = 8 or a mod 10 = 9) }" },
+	{ 1, "{ [i, j] : 0 <= j <= 2 and "
+		"(0 <= i <= 1 or 4 <= i <= 5 or 8 <= i <= 9 or "
+		"2 <= i <= 3 or 6 <= i <= 7) }" },
+	{ 0, "{ [i, j] : 0 <= i <= 2 and 0 <= j <= 2 or "
+		"i = 4 and j = 1 or 0 <= i - j <= 1 and 6 <= i <= 7 }" },
 };
 
 /* A specialized coalescing test case that would result
@@ -4233,6 +4239,414 @@ static int test_schedule_incremental(isl_ctx *ctx)
 	return r;
 }
 
+/* Check that isl_schedule_constraints_update_schedule keeps
+ * the previous schedule of a component that is not affected
+ * by a change in the schedule constraints and that it recomputes
+ * a valid schedule for a component that is affected.
+ * In particular, the direction of the dependence between the instances
+ * of B is reversed, while the dependence between the instances of A
+ * remains unchanged.
+ */
+static int test_schedule_update(isl_ctx *ctx)
+{
+	const char *str;
+	isl_union_set *domain, *A;
+	isl_union_map *validity, *map, *prev_map, *before;
+	isl_schedule_constraints *sc, *prev_sc;
+	isl_schedule *prev, *sched;
+	isl_bool equal, valid;
+
+	str = "[n] -> { A[i] : 0 <= i < n; B[i] : 0 <= i < n }";
+	domain = isl_union_set_read_from_str(ctx, str);
+	str = "[n] -> { A[i] -> A[i + 1]; B[i] -> B[i + 1] }";
+	validity = isl_union_map_read_from_str(ctx, str);
+	prev_sc = isl_schedule_constraints_on_domain(
+					isl_union_set_copy(domain));
+	prev_sc = isl_schedule_constraints_set_validity(prev_sc, validity);
+	prev = isl_schedule_constraints_compute_schedule(
+				isl_schedule_constraints_copy(prev_sc));
+
+	str = "[n] -> { A[i] -> A[i + 1]; B[i] -> B[i - 1] }";
+	validity = isl_union_map_read_from_str(ctx, str);
+	sc = isl_schedule_constraints_on_domain(domain);
+	sc = isl_schedule_constraints_set_validity(sc,
+					isl_union_map_copy(validity));
+	prev_map = isl_schedule_get_map(prev);
+	sched = isl_schedule_constraints_update_schedule(sc, prev_sc, prev);
+	map = isl_schedule_get_map(sched);
+	isl_schedule_free(sched);
+
+	str = "[n] -> { A[i] }";
+	A = isl_union_set_read_from_str(ctx, str);
+	prev_map = isl_union_map_intersect_domain(prev_map,
+						isl_union_set_copy(A));
+	before = isl_union_map_lex_lt_union_map(isl_union_map_copy(map),
+						isl_union_map_copy(map));
+	valid = isl_union_map_is_subset(validity, before);
+	map = isl_union_map_intersect_domain(map, A);
+	equal = isl_union_map_is_equal(map, prev_map);
+	isl_union_map_free(map);
+	isl_union_map_free(prev_map);
+	isl_union_map_free(validity);
+	isl_union_map_free(before);
+
+	if (equal < 0 || valid < 0)
+		return -1;
+	if (!equal)
+		isl_die(ctx, isl_error_unknown,
+			"schedule of unaffected component not reused",
+			return -1);
+	if (!valid)
+		isl_die(ctx, isl_error_unknown,
+			"updated schedule not valid", return -1);
+
+	return 0;
+}
+
+/* Return the relation between the instances in "domain" that
+ * are scheduled before each other by "sched".
+ */
+static __isl_give isl_union_map *schedule_order_on(
+	__isl_keep isl_schedule *sched, __isl_keep isl_union_set *domain)
+{
+	isl_union_map *map;
+
+	map = isl_schedule_get_map(sched);
+	map = isl_union_map_intersect_domain(map, isl_union_set_copy(domain));
+	return isl_union_map_lex_lt_union_map(isl_union_map_copy(map), map);
+}
+
+/* Check that isl_schedule_constraints_update_schedule recomputes
+ * the schedule of a component on which only the proximity constraints
+ * have changed, even though the previous schedule of the component
+ * still respects all its (non-existent) validity constraints.
+ * In particular, the changed proximity constraints on A
+ * result in a different loop order, which should appear
+ * in the updated schedule.  The instances of A should be
+ * ordered in the same way as by a schedule computed from scratch.
+ */
+static int test_schedule_update_proximity(isl_ctx *ctx)
+{
+	const char *str;
+	isl_union_set *domain, *A;
+	isl_union_map *proximity, *map, *prev_map, *fresh_map;
+	isl_schedule_constraints *sc, *prev_sc;
+	isl_schedule *prev, *sched, *fresh;
+	isl_bool equal, changed;
+
+	str = "[n] -> { A[i, j] : 0 <= i, j < n; B[i] : 0 <= i < n }";
+	domain = isl_union_set_read_from_str(ctx, str);
+	str = "[n] -> { A[i, j] -> A[i, j + 1]; B[i] -> B[i + 1] }";
+	proximity = isl_union_map_read_from_str(ctx, str);
+	prev_sc = isl_schedule_constraints_on_domain(
+					isl_union_set_copy(domain));
+	prev_sc = isl_schedule_constraints_set_proximity(prev_sc, proximity);
+	prev = isl_schedule_constraints_compute_schedule(
+				isl_schedule_constraints_copy(prev_sc));
+	str = "[n] -> { A[i, j] }";
+	A = isl_union_set_read_from_str(ctx, str);
+	prev_map = schedule_order_on(prev, A);
+
+	str = "[n] -> { A[i, j] -> A[i + 1, j]; B[i] -> B[i + 1] }";
+	proximity = isl_union_map_read_from_str(ctx, str);
+	sc = isl_schedule_constraints_on_domain(domain);
+	sc = isl_schedule_constraints_set_proximity(sc, proximity);
+	fresh = isl_schedule_constraints_compute_schedule(
+				isl_schedule_constraints_copy(sc));
+	sched = isl_schedule_constraints_update_schedule(sc, prev_sc, prev);
+
+	map = schedule_order_on(sched, A);
+	fresh_map = schedule_order_on(fresh, A);
+	isl_union_set_free(A);
+	equal = isl_union_map_is_equal(map, fresh_map);
+	changed = isl_union_map_is_equal(map, prev_map);
+	if (changed >= 0)
+		changed = !changed;
+	isl_union_map_free(map);
+	isl_union_map_free(fresh_map);
+	isl_union_map_free(prev_map);
+	isl_schedule_free(sched);
+	isl_schedule_free(fresh);
+
+	if (equal < 0 || changed < 0)
+		return -1;
+	if (!changed)
+		isl_die(ctx, isl_error_unknown,
+			"schedule of affected component reused", return -1);
+	if (!equal)
+		isl_die(ctx, isl_error_unknown,
+			"unexpected updated schedule", return -1);
+
+	return 0;
+}
+
+/* Increment the number of mark nodes pointed to by "user"
+ * if "node" is a mark node.
+ */
+static isl_bool count_mark(__isl_keep isl_schedule_node *node, void *user)
+{
+	int *n_mark = user;
+
+	if (isl_schedule_node_get_type(node) == isl_schedule_node_mark)
+		(*n_mark)++;
+
+	return isl_bool_true;
+}
+
+/* Check that a schedule is computed even if the per-component
+ * operation budget is exceeded for every component and that
+ * each of these components is marked in the result.
+ * Also check that the result respects the validity constraints.
+ * Exceeding the budget should not be reported as an error,
+ * so the computation is performed with on_error set to
+ * ISL_ON_ERROR_ABORT.
+ */
+static int test_schedule_budget(isl_ctx *ctx)
+{
+	const char *str;
+	int budget, on_error;
+	int n_mark = 0;
+	isl_union_set *domain;
+	isl_union_map *validity, *map, *before;
+	isl_schedule_constraints *sc;
+	isl_schedule *sched;
+	isl_stat r;
+	isl_bool valid;
+
+	str = "[n] -> { A[i, j] : 0 <= i, j < n; B[i] : 0 <= i < n }";
+	domain = isl_union_set_read_from_str(ctx, str);
+	str = "[n] -> { A[i, j] -> A[i + 1, j - 1]; A[i, j] -> A[i, j + 1]; "
+		"B[i] -> B[i + 1] }";
+	validity = isl_union_map_read_from_str(ctx, str);
+	sc = isl_schedule_constraints_on_domain(domain);
+	sc = isl_schedule_constraints_set_validity(sc,
+					isl_union_map_copy(validity));
+
+	budget = isl_options_get_schedule_max_operations(ctx);
+	on_error = isl_options_get_on_error(ctx);
+	isl_options_set_schedule_max_operations(ctx, 1);
+	isl_options_set_on_error(ctx, ISL_ON_ERROR_ABORT);
+	sched = isl_schedule_constraints_compute_schedule(sc);
+	isl_options_set_schedule_max_operations(ctx, budget);
+	isl_options_set_on_error(ctx, on_error);
+
+	r = isl_schedule_foreach_schedule_node_top_down(sched,
+						&count_mark, &n_mark);
+	map = isl_schedule_get_map(sched);
+	isl_schedule_free(sched);
+	before = isl_union_map_lex_lt_union_map(isl_union_map_copy(map), map);
+	valid = isl_union_map_is_subset(validity, before);
+	isl_union_map_free(validity);
+	isl_union_map_free(before);
+
+	if (r < 0 || valid < 0)
+		return -1;
+	if (!valid)
+		isl_die(ctx, isl_error_unknown,
+			"schedule not valid", return -1);
+	if (n_mark != 2)
+		isl_die(ctx, isl_error_unknown,
+			"expecting two degraded components", return -1);
+
+	return 0;
+}
+
+/* Skip a quoted string of lower case letters and underscores
+ * at the start of "s" and return a pointer to the first character
+ * after the string, or NULL if there is no such string.
+ */
+static const char *skip_trace_name(const char *s)
+{
+	if (*s++ != '"')
+		return NULL;
+	while ((*s >= 'a' && *s <= 'z') || *s == '_')
+		++s;
+	if (*s++ != '"')
+		return NULL;
+	return s;
+}
+
+/* Is "record" a well-formed scheduler trace record?
+ * That is, is it of the form
+ *
+ *	{ "event": "name", "key": value, ... }
+ *
+ * with each value either a quoted name or an integer?
+ */
+static int is_trace_record(const char *record)
+{
+	int first = 1;
+	const char *s = record;
+
+	if (strncmp(s, "{ \"event\": ", 11) != 0)
+		return 0;
+	s += 2;
+	while (1) {
+		s = skip_trace_name(s);
+		if (!s || strncmp(s, ": ", 2) != 0)
+			return 0;
+		s += 2;
+		if (*s == '"') {
+			s = skip_trace_name(s);
+			if (!s)
+				return 0;
+		} else {
+			if (first)
+				return 0;
+			if (*s == '-')
+				++s;
+			if (*s < '0' || *s > '9')
+				return 0;
+			while (*s >= '0' && *s <= '9')
+				++s;
+		}
+		first = 0;
+		if (strcmp(s, " }") == 0)
+			return 1;
+		if (strncmp(s, ", ", 2) != 0)
+			return 0;
+		s += 2;
+	}
+}
+
+/* Data used by collect_trace_record.
+ *
+ * "n" is the number of records.
+ * "n_band" is the number of records of type "band".
+ * "invalid" is set if any of the records is not well-formed.
+ */
+struct isl_test_trace_data {
+	int n;
+	int n_band;
+	int n_band_lp;
+	int n_carry_lp;
+	int invalid;
+};
+
+/* Keep track of the scheduler trace record "record".
+ */
+static void collect_trace_record(const char *record, void *user)
+{
+	struct isl_test_trace_data *data = user;
+
+	data->n++;
+	if (!is_trace_record(record))
+		data->invalid = 1;
+	if (strncmp(record, "{ \"event\": \"band\"", 17) == 0)
+		data->n_band++;
+	if (strncmp(record,
+		    "{ \"event\": \"lp\", \"kind\": \"band\"", 31) == 0)
+		data->n_band_lp++;
+	if (strncmp(record,
+		    "{ \"event\": \"lp\", \"kind\": \"carry\"", 32) == 0)
+		data->n_carry_lp++;
+}
+
+/* Check that the scheduler trace consists of well-formed records,
+ * that they are passed to the trace callback and
+ * that a record is produced for each of the bands
+ * in the computed schedule.
+ */
+static int test_schedule_trace(isl_ctx *ctx)
+{
+	const char *str;
+	int trace;
+	isl_union_set *domain;
+	isl_union_map *validity;
+	isl_schedule_constraints *sc;
+	isl_schedule *sched;
+	struct isl_test_trace_data data = { 0 };
+
+	str = "[n] -> { A[i, j] : 0 <= i, j < n; B[i] : 0 <= i < n }";
+	domain = isl_union_set_read_from_str(ctx, str);
+	str = "[n] -> { A[i, j] -> A[i + 1, j - 1]; A[i, j] -> B[j]; "
+		"B[i] -> B[i + 1] }";
+	validity = isl_union_map_read_from_str(ctx, str);
+	sc = isl_schedule_constraints_on_domain(domain);
+	sc = isl_schedule_constraints_set_validity(sc, validity);
+
+	trace = isl_options_get_schedule_trace(ctx);
+	isl_options_set_schedule_trace(ctx, 1);
+	isl_ctx_set_schedule_trace_callback(ctx, &collect_trace_record, &data);
+	sched = isl_schedule_constraints_compute_schedule(sc);
+	isl_ctx_set_schedule_trace_callback(ctx, NULL, NULL);
+	isl_options_set_schedule_trace(ctx, trace);
+	isl_schedule_free(sched);
+
+	if (!sched)
+		return -1;
+	if (data.invalid)
+		isl_die(ctx, isl_error_unknown, "malformed trace record",
+			return -1);
+	if (data.n_band < 1 || data.n <= data.n_band)
+		isl_die(ctx, isl_error_unknown, "missing trace records",
+			return -1);
+
+	return 0;
+}
+
+/* Check that the fallback strategy for a component that exceeds
+ * its operation budget does not itself perform an unbounded amount
+ * of work, even if the budget is so small that the fallback
+ * also exceeds it.
+ * In particular, check that the fallback only solves LP problems
+ * for carrying dependences, one for each of the two dependences
+ * in the input, and that it does not extend the schedule
+ * to a full-dimensional schedule by solving the LP problems
+ * of the default scheduler, as Feautrier's algorithm would.
+ * Also check that the result respects the validity constraints.
+ */
+static int test_schedule_budget_fallback(isl_ctx *ctx)
+{
+	const char *str;
+	int budget, trace;
+	isl_union_set *domain;
+	isl_union_map *validity, *map, *before;
+	isl_schedule_constraints *sc;
+	isl_schedule *sched;
+	isl_bool valid;
+	struct isl_test_trace_data data = { 0 };
+
+	str = "[n] -> { A[i, j, k] : 0 <= i, j, k < n }";
+	domain = isl_union_set_read_from_str(ctx, str);
+	str = "[n] -> { A[i, j, k] -> A[i + 1, j, k]; "
+		"A[i, j, k] -> A[i, j + 1, k + 1] }";
+	validity = isl_union_map_read_from_str(ctx, str);
+	sc = isl_schedule_constraints_on_domain(domain);
+	sc = isl_schedule_constraints_set_validity(sc,
+					isl_union_map_copy(validity));
+	sc = isl_schedule_constraints_set_proximity(sc,
+					isl_union_map_copy(validity));
+
+	budget = isl_options_get_schedule_max_operations(ctx);
+	trace = isl_options_get_schedule_trace(ctx);
+	isl_options_set_schedule_max_operations(ctx, 1);
+	isl_options_set_schedule_trace(ctx, 1);
+	isl_ctx_set_schedule_trace_callback(ctx, &collect_trace_record, &data);
+	sched = isl_schedule_constraints_compute_schedule(sc);
+	isl_ctx_set_schedule_trace_callback(ctx, NULL, NULL);
+	isl_options_set_schedule_trace(ctx, trace);
+	isl_options_set_schedule_max_operations(ctx, budget);
+
+	map = isl_schedule_get_map(sched);
+	isl_schedule_free(sched);
+	before = isl_union_map_lex_lt_union_map(isl_union_map_copy(map), map);
+	valid = isl_union_map_is_subset(validity, before);
+	isl_union_map_free(validity);
+	isl_union_map_free(before);
+
+	if (valid < 0)
+		return -1;
+	if (!valid)
+		isl_die(ctx, isl_error_unknown,
+			"schedule not valid", return -1);
+	if (data.n_band_lp != 0 || data.n_carry_lp < 1 || data.n_carry_lp > 2)
+		isl_die(ctx, isl_error_unknown,
+			"unexpected work in fallback strategy", return -1);
+
+	return 0;
+}
+
 int test_plain_injective(isl_ctx *ctx, const char *str, int injective)
 {
 	isl_union_map *umap;
@@ -6021,6 +6435,104 @@ static int test_ast_gen5(isl_ctx *ctx)
 	return 0;
 }
 
+/* Add "node" to the isl_ast_node_list pointed to by "user".
+ */
+static isl_stat collect_ast_node(__isl_take isl_ast_node *node, void *user)
+{
+	isl_ast_node_list **list = user;
+
+	*list = isl_ast_node_list_add(*list, node);
+
+	return *list ? isl_stat_ok : isl_stat_error;
+}
+
+/* Check that isl_ast_build_foreach_node_from_schedule produces
+ * the top-level nodes of the AST produced by
+ * isl_ast_build_node_from_schedule on the schedule tree "str".
+ */
+static int check_ast_foreach_node(isl_ctx *ctx, const char *str)
+{
+	int i, n;
+	isl_ast_build *build;
+	isl_ast_node *tree;
+	isl_ast_node_list *expected, *list;
+	isl_schedule *schedule;
+	isl_stat r;
+	int equal = 1;
+
+	schedule = isl_schedule_read_from_str(ctx, str);
+	build = isl_ast_build_alloc(ctx);
+	tree = isl_ast_build_node_from_schedule(build,
+					isl_schedule_copy(schedule));
+	list = isl_ast_node_list_alloc(ctx, 0);
+	r = isl_ast_build_foreach_node_from_schedule(build, schedule,
+						&collect_ast_node, &list);
+	isl_ast_build_free(build);
+	if (isl_ast_node_get_type(tree) == isl_ast_node_block)
+		expected = isl_ast_node_block_get_children(tree);
+	else
+		expected = isl_ast_node_list_from_ast_node(
+						isl_ast_node_copy(tree));
+	isl_ast_node_free(tree);
+
+	if (r < 0 || !expected || !list)
+		equal = -1;
+	n = isl_ast_node_list_n_ast_node(expected);
+	if (equal >= 0 && n != isl_ast_node_list_n_ast_node(list))
+		equal = 0;
+	for (i = 0; equal > 0 && i < n; ++i) {
+		isl_ast_node *node1, *node2;
+		char *str1, *str2;
+
+		node1 = isl_ast_node_list_get_ast_node(expected, i);
+		node2 = isl_ast_node_list_get_ast_node(list, i);
+		str1 = isl_ast_node_to_str(node1);
+		str2 = isl_ast_node_to_str(node2);
+		if (!str1 || !str2)
+			equal = -1;
+		else
+			equal = !strcmp(str1, str2);
+		free(str1);
+		free(str2);
+		isl_ast_node_free(node1);
+		isl_ast_node_free(node2);
+	}
+	isl_ast_node_list_free(expected);
+	isl_ast_node_list_free(list);
+
+	if (equal < 0)
+		return -1;
+	if (!equal)
+		isl_die(ctx, isl_error_unknown, "unexpected top-level nodes",
+			return -1);
+
+	return 0;
+}
+
+/* Check that isl_ast_build_foreach_node_from_schedule produces
+ * the same nodes as isl_ast_build_node_from_schedule,
+ * in particular when top-level statements share a guard and
+ * therefore get merged into a single if node.
+ */
+static int test_ast_gen6(isl_ctx *ctx)
+{
+	const char *str;
+
+	str = "{ domain: \"[n] -> { A[]; B[] : n >= 1; C[] : n >= 1; "
+		"D[i] : 0 <= i < n }\", child: { sequence: [ "
+		"{ filter: \"{ A[] }\" }, { filter: \"{ B[] }\" }, "
+		"{ filter: \"{ C[] }\" }, { filter: \"{ D[i] }\", "
+		"child: { schedule: \"[{ D[i] -> [(i)] }]\" } } ] } }";
+	if (check_ast_foreach_node(ctx, str) < 0)
+		return -1;
+	str = "{ domain: \"[n] -> { A[i] : 0 <= i < n }\", "
+		"child: { schedule: \"[{ A[i] -> [(i)] }]\" } }";
+	if (check_ast_foreach_node(ctx, str) < 0)
+		return -1;
+
+	return 0;
+}
+
 static int test_ast_gen(isl_ctx *ctx)
 {
 	if (test_ast_gen1(ctx) < 0)
@@ -6033,6 +6545,8 @@ static int test_ast_gen(isl_ctx *ctx)
 		return -1;
 	if (test_ast_gen5(ctx) < 0)
 		return -1;
+	if (test_ast_gen6(ctx) < 0)
+		return -1;
 	return 0;
 }
 
@@ -6617,10 +7131,569 @@ static int test_universe(isl_ctx *ctx)
 	return 0;
 }
 
+/* Check that the statistics collected by "ctx" get updated
+ * by a coalescing operation and that they can be printed as JSON.
+ */
+static int test_stats(isl_ctx *ctx)
+{
+	const char *str;
+	const char *prefix = "{ \"gbr_solved_lps\": ";
+	const struct isl_stats *stats;
+	isl_map *map;
+	isl_printer *p;
+	char *s;
+	int ok;
+
+	isl_ctx_reset_stats(ctx);
+	str = "{ [i] -> [j] : 0 <= i <= 10 and j = i; "
+		"[i] -> [j] : 11 <= i <= 20 and j = i }";
+	map = isl_map_read_from_str(ctx, str);
+	map = isl_map_coalesce(map);
+	if (!map)
+		return -1;
+	isl_map_free(map);
+
+	stats = isl_ctx_get_stats(ctx);
+	if (!stats)
+		return -1;
+	if (stats->coalesce_pair_tests == 0 || stats->pivots == 0)
+		isl_die(ctx, isl_error_unknown, "statistics not updated",
+			return -1);
+
+	p = isl_printer_to_str(ctx);
+	p = isl_printer_set_yaml_style(p, ISL_YAML_STYLE_FLOW);
+	p = isl_printer_print_stats(p, stats);
+	s = isl_printer_get_str(p);
+	isl_printer_free(p);
+	if (!s)
+		return -1;
+	ok = !strncmp(s, prefix, strlen(prefix));
+	free(s);
+	if (!ok)
+		isl_die(ctx, isl_error_unknown, "unexpected output",
+			return -1);
+
+	return 0;
+}
+
+/* Check that the maximum of the affine expression described by "obj_str"
+ * over the basic set of "lp" is equal to the value described by "res".
+ */
+static int check_lp_session_max(isl_lp_session *lp, const char *obj_str,
+	const char *res)
+{
+	isl_ctx *ctx;
+	isl_aff *obj;
+	isl_val *val, *expected;
+	isl_bool equal;
+
+	ctx = isl_lp_session_get_ctx(lp);
+	obj = isl_aff_read_from_str(ctx, obj_str);
+	val = isl_lp_session_max_val(lp, obj);
+	isl_aff_free(obj);
+	expected = isl_val_read_from_str(ctx, res);
+	if (isl_val_is_nan(expected))
+		equal = isl_val_is_nan(val);
+	else
+		equal = isl_val_eq(val, expected);
+	isl_val_free(val);
+	isl_val_free(expected);
+	if (equal < 0)
+		return -1;
+	if (!equal)
+		isl_die(ctx, isl_error_unknown, "unexpected optimum",
+			return -1);
+
+	return 0;
+}
+
+/* Return the single constraint of the basic set described by "str".
+ */
+static __isl_give isl_constraint *read_constraint(isl_ctx *ctx,
+	const char *str)
+{
+	isl_basic_set *bset;
+	isl_constraint_list *list;
+	isl_constraint *c;
+
+	bset = isl_basic_set_read_from_str(ctx, str);
+	list = isl_basic_set_get_constraint_list(bset);
+	isl_basic_set_free(bset);
+	c = isl_constraint_list_get_constraint(list, 0);
+	isl_constraint_list_free(list);
+
+	return c;
+}
+
+/* Check that an LP session produces the correct optima
+ * after adding constraints and rolling them back.
+ */
+static int test_lp_session(isl_ctx *ctx)
+{
+	isl_basic_set *bset;
+	isl_constraint *c;
+	isl_lp_session *lp;
+	int r = 0;
+
+	bset = isl_basic_set_read_from_str(ctx,
+				"{ [i, j] : 0 <= i <= 10 and 0 <= 2j <= i }");
+	lp = isl_lp_session_alloc(bset);
+	if (!lp)
+		return -1;
+
+	if (check_lp_session_max(lp, "{ [i, j] -> [(i + j)] }", "15") < 0 ||
+	    check_lp_session_max(lp, "{ [i, j] -> [(j - i)] }", "0") < 0)
+		r = -1;
+
+	if (r == 0 && isl_lp_session_snapshot(lp) < 0)
+		r = -1;
+	if (r == 0) {
+		c = read_constraint(ctx, "{ [i, j] : i <= 5 }");
+		if (isl_lp_session_add_constraint(lp, c) < 0 ||
+		    check_lp_session_max(lp, "{ [i, j] -> [(i + j)] }",
+					"15/2") < 0)
+			r = -1;
+	}
+	if (r == 0 && isl_lp_session_snapshot(lp) < 0)
+		r = -1;
+	if (r == 0) {
+		c = read_constraint(ctx, "{ [i, j] : j >= 3 }");
+		if (isl_lp_session_add_constraint(lp, c) < 0 ||
+		    check_lp_session_max(lp, "{ [i, j] -> [(i)] }", "NaN") < 0)
+			r = -1;
+	}
+	if (r == 0 && (isl_lp_session_rollback(lp) < 0 ||
+	    check_lp_session_max(lp, "{ [i, j] -> [(j)] }", "5/2") < 0))
+		r = -1;
+	if (r == 0 && (isl_lp_session_rollback(lp) < 0 ||
+	    check_lp_session_max(lp, "{ [i, j] -> [(i + j)] }", "15") < 0))
+		r = -1;
+
+	isl_lp_session_free(lp);
+
+	return r;
+}
+
+/* Check that repeated emptiness and boundedness tests
+ * on the same basic sets hit the sample cache and
+ * produce the same results.
+ */
+static int test_sample_cache(isl_ctx *ctx)
+{
+	int i, j;
+	int size;
+	const char *str[] = {
+		"{ [i, j] : 0 <= 2i - 3j <= 1 and 3 <= i + j <= 4 }",
+		"{ [i, j] : 1 <= 4i - 2j <= 1 and 0 <= i <= 10 }",
+	};
+	int expected[] = { 0, 1 };
+	const struct isl_stats *stats;
+
+	size = isl_options_get_sample_cache_size(ctx);
+	isl_options_set_sample_cache_size(ctx, 4);
+	isl_ctx_reset_stats(ctx);
+	for (i = 0; i < 2; ++i) {
+		for (j = 0; j < 2; ++j) {
+			isl_basic_set *bset;
+			isl_bool empty;
+			int bounded;
+
+			bset = isl_basic_set_read_from_str(ctx, str[j]);
+			empty = isl_basic_set_is_empty(bset);
+			bounded = isl_basic_set_is_bounded(bset);
+			isl_basic_set_free(bset);
+			if (empty < 0 || bounded < 0)
+				break;
+			if (empty != expected[j] || !bounded)
+				isl_die(ctx, isl_error_unknown,
+					"unexpected result", break);
+		}
+		if (j < 2)
+			break;
+	}
+	stats = isl_ctx_get_stats(ctx);
+	isl_options_set_sample_cache_size(ctx, size);
+	if (i < 2 || !stats)
+		return -1;
+	if (stats->sample_cache_hits == 0)
+		isl_die(ctx, isl_error_unknown, "sample cache not used",
+			return -1);
+
+	return 0;
+}
+
+/* Check that repeated computations of the coefficients of
+ * the same (but separately constructed) sets hit the coefficients cache
+ * and produce the same results.
+ */
+static int test_coefficients_cache(isl_ctx *ctx)
+{
+	int i;
+	int size;
+	const char *str = "{ [i, j] : 0 <= i <= 10 and i <= j <= 2i }";
+	isl_basic_set *coeff[2];
+	isl_bool equal;
+	const struct isl_stats *stats;
+
+	size = isl_options_get_coefficients_cache_size(ctx);
+	isl_options_set_coefficients_cache_size(ctx, 4);
+	isl_ctx_reset_stats(ctx);
+	for (i = 0; i < 2; ++i) {
+		isl_basic_set *bset;
+
+		bset = isl_basic_set_read_from_str(ctx, str);
+		coeff[i] = isl_basic_set_coefficients(bset);
+	}
+	stats = isl_ctx_get_stats(ctx);
+	isl_options_set_coefficients_cache_size(ctx, size);
+	equal = isl_basic_set_is_equal(coeff[0], coeff[1]);
+	isl_basic_set_free(coeff[0]);
+	isl_basic_set_free(coeff[1]);
+	if (equal < 0 || !stats)
+		return -1;
+	if (!equal)
+		isl_die(ctx, isl_error_unknown, "unexpected result",
+			return -1);
+	if (stats->coefficients_cache_hits != 1)
+		isl_die(ctx, isl_error_unknown, "coefficients cache not used",
+			return -1);
+
+	return 0;
+}
+
+/* Check that updating the result of a dataflow analysis after
+ * changing the accesses to one of the arrays produces the same result
+ * as performing the analysis on the updated accesses from scratch.
+ */
+static int test_flow_update(isl_ctx *ctx)
+{
+	int i;
+	const char *str;
+	const char *schedule_str;
+	isl_union_map *map;
+	isl_union_access_info *access[2];
+	isl_union_flow *flow, *update;
+	isl_schedule *schedule;
+	isl_bool equal = isl_bool_true;
+	__isl_give isl_union_map *(*get[])(__isl_keep isl_union_flow *flow) = {
+		&isl_union_flow_get_full_must_dependence,
+		&isl_union_flow_get_full_may_dependence,
+		&isl_union_flow_get_must_no_source,
+		&isl_union_flow_get_may_no_source,
+	};
+
+	schedule_str = "{ domain: \"{ S[i] : 0 <= i < 10; "
+		"T[i] : 0 <= i < 10 }\", "
+		"child: { schedule: \"[{ S[i] -> [i]; T[i] -> [i] }]\", "
+		"child: { sequence: [ { filter: \"{ S[i] }\" }, "
+		"{ filter: \"{ T[i] }\" } ] } } }";
+
+	str = "{ T[i] -> A[i]; T[i] -> B[i] }";
+	map = isl_union_map_read_from_str(ctx, str);
+	access[0] = isl_union_access_info_from_sink(map);
+	str = "{ T[i] -> A[i]; T[i] -> B[i - 1] }";
+	map = isl_union_map_read_from_str(ctx, str);
+	access[1] = isl_union_access_info_from_sink(map);
+	for (i = 0; i < 2; ++i) {
+		str = "{ S[i] -> A[i]; S[i] -> B[i] }";
+		map = isl_union_map_read_from_str(ctx, str);
+		access[i] = isl_union_access_info_set_must_source(access[i],
+								map);
+		schedule = isl_schedule_read_from_str(ctx, schedule_str);
+		access[i] = isl_union_access_info_set_schedule(access[i],
+								schedule);
+	}
+
+	flow = isl_union_access_info_compute_flow(
+				isl_union_access_info_copy(access[0]));
+	update = isl_union_access_info_update_flow(
+				isl_union_access_info_copy(access[1]),
+				access[0], flow);
+	flow = isl_union_access_info_compute_flow(access[1]);
+	for (i = 0; equal == isl_bool_true && i < 4; ++i) {
+		isl_union_map *map1, *map2;
+
+		map1 = get[i](flow);
+		map2 = get[i](update);
+		equal = isl_union_map_is_equal(map1, map2);
+		isl_union_map_free(map1);
+		isl_union_map_free(map2);
+	}
+	isl_union_flow_free(flow);
+	isl_union_flow_free(update);
+
+	if (equal < 0)
+		return -1;
+	if (!equal)
+		isl_die(ctx, isl_error_unknown, "unexpected update result",
+			return -1);
+
+	return 0;
+}
+
+/* Perform dataflow analysis for the sinks described by "sink"
+ * with respect to the writes and the schedule of test_flow_lexmax_cache.
+ */
+static __isl_give isl_union_flow *compute_lexmax_cache_flow(isl_ctx *ctx,
+	const char *sink)
+{
+	const char *str;
+	isl_union_map *map;
+	isl_union_access_info *access;
+	isl_schedule *schedule;
+
+	map = isl_union_map_read_from_str(ctx, sink);
+	access = isl_union_access_info_from_sink(map);
+	str = "{ W[i] -> A[i] : 0 <= i < 5 }";
+	map = isl_union_map_read_from_str(ctx, str);
+	access = isl_union_access_info_set_must_source(access, map);
+	str = "{ domain: \"{ W[i] : 0 <= i < 5; R1[i] : 0 <= i < 10; "
+		"R2[i] : 0 <= i < 10 }\", child: "
+		"{ schedule: \"[{ W[i] -> [i]; R1[i] -> [i]; R2[i] -> [i] }, "
+		"{ W[i] -> [0]; R1[i] -> [1]; R2[i] -> [1] }]\" } }";
+	schedule = isl_schedule_read_from_str(ctx, str);
+	access = isl_union_access_info_set_schedule(access, schedule);
+	return isl_union_access_info_compute_flow(access);
+}
+
+/* Check that the dataflow analysis reuses the result of
+ * a partial lexicographic maximization for sinks that access
+ * the same array in the same way and that the result is not affected.
+ * The two sinks only differ in their statement names.
+ * The result of analyzing them together, where the second sink
+ * reuses the maximization of the first, is compared to
+ * the combined results of analyzing them separately,
+ * where no maximization can be reused.
+ * Since only part of the sink iterations have a source,
+ * both the dependences and the iterations without source
+ * are affected by the cache.
+ */
+static int test_flow_lexmax_cache(isl_ctx *ctx)
+{
+	int i;
+	const char *sink[] = {
+		"{ R1[i] -> A[i] : 0 <= i < 10 }",
+		"{ R2[i] -> A[i] : 0 <= i < 10 }",
+	};
+	const char *str;
+	isl_union_flow *flow, *separate[2];
+	const struct isl_stats *stats;
+	long hits;
+	isl_bool equal = isl_bool_true;
+	__isl_give isl_union_map *(*get[])(__isl_keep isl_union_flow *flow) = {
+		&isl_union_flow_get_full_must_dependence,
+		&isl_union_flow_get_full_may_dependence,
+		&isl_union_flow_get_must_no_source,
+		&isl_union_flow_get_may_no_source,
+	};
+
+	for (i = 0; i < 2; ++i)
+		separate[i] = compute_lexmax_cache_flow(ctx, sink[i]);
+	str = "{ R1[i] -> A[i] : 0 <= i < 10; R2[i] -> A[i] : 0 <= i < 10 }";
+	isl_ctx_reset_stats(ctx);
+	flow = compute_lexmax_cache_flow(ctx, str);
+	stats = isl_ctx_get_stats(ctx);
+	hits = stats ? stats->flow_lexmax_cache_hits : -1;
+	for (i = 0; equal == isl_bool_true && i < 4; ++i) {
+		isl_union_map *map1, *map2;
+
+		map1 = get[i](flow);
+		map2 = isl_union_map_union(get[i](separate[0]),
+					get[i](separate[1]));
+		equal = isl_union_map_is_equal(map1, map2);
+		isl_union_map_free(map1);
+		isl_union_map_free(map2);
+	}
+	isl_union_flow_free(flow);
+	isl_union_flow_free(separate[0]);
+	isl_union_flow_free(separate[1]);
+
+	if (equal < 0 || hits < 0)
+		return -1;
+	if (!equal)
+		isl_die(ctx, isl_error_unknown, "unexpected dependences",
+			return -1);
+	if (hits < 1)
+		isl_die(ctx, isl_error_unknown, "lexmax cache not used",
+			return -1);
+
+	return 0;
+}
+
+/* Check that converting the same piecewise affine expression twice
+ * in the same AST build context reuses the result of the first conversion
+ * and that both conversions produce the same AST expression.
+ */
+static int test_ast_expr_cache(isl_ctx *ctx)
+{
+	isl_set *context;
+	isl_pw_aff *pa;
+	isl_ast_build *build;
+	isl_ast_expr *expr1, *expr2;
+	const struct isl_stats *stats;
+	isl_bool equal;
+
+	context = isl_set_read_from_str(ctx, "[n] -> { : n >= 0 }");
+	build = isl_ast_build_from_context(context);
+	pa = isl_pw_aff_read_from_str(ctx,
+				"[n] -> { [(n - 4 * floor(n/4) + n)] }");
+	isl_ctx_reset_stats(ctx);
+	expr1 = isl_ast_build_expr_from_pw_aff(build, isl_pw_aff_copy(pa));
+	expr2 = isl_ast_build_expr_from_pw_aff(build, pa);
+	stats = isl_ctx_get_stats(ctx);
+	equal = isl_ast_expr_is_equal(expr1, expr2);
+	isl_ast_expr_free(expr1);
+	isl_ast_expr_free(expr2);
+	isl_ast_build_free(build);
+
+	if (equal < 0 || !stats)
+		return -1;
+	if (!equal)
+		isl_die(ctx, isl_error_unknown, "unexpected AST expression",
+			return -1);
+	if (stats->ast_expr_cache_hits < 1)
+		isl_die(ctx, isl_error_unknown, "AST expression cache not used",
+			return -1);
+
+	return 0;
+}
+
+/* Check that transferring an object to another isl_ctx and back
+ * results in an object that is equal to the original.
+ */
+/* Check that transferring a multi union piecewise affine expression
+ * to "ctx2" and back to "ctx" produces the original expression.
+ */
+static isl_bool check_transfer_mupa(isl_ctx *ctx, isl_ctx *ctx2)
+{
+	const char *str;
+	isl_multi_union_pw_aff *mupa, *mupa2;
+	isl_bool equal;
+
+	str = "[n] -> [{ A[i] -> [(floor(i/2))] : i >= 0; "
+		"A[i] -> [(n)] : i < 0; B[i, j] -> [(i + j)] }, "
+		"{ A[i] -> [(0)]; B[i, j] -> [(n - j)] }]";
+	mupa = isl_multi_union_pw_aff_read_from_str(ctx, str);
+	mupa2 = isl_multi_union_pw_aff_transfer(
+				isl_multi_union_pw_aff_copy(mupa), ctx2);
+	if (mupa2 && isl_multi_union_pw_aff_get_ctx(mupa2) != ctx2)
+		isl_die(ctx, isl_error_unknown, "object not transferred",
+			mupa2 = isl_multi_union_pw_aff_free(mupa2));
+	mupa2 = isl_multi_union_pw_aff_transfer(mupa2, ctx);
+	equal = isl_multi_union_pw_aff_plain_is_equal(mupa, mupa2);
+	isl_multi_union_pw_aff_free(mupa);
+	isl_multi_union_pw_aff_free(mupa2);
+
+	return equal;
+}
+
+/* Check that a schedule tree can be transferred to "ctx2",
+ * that it can be used there and that transferring it back to "ctx"
+ * produces the original schedule.
+ */
+static isl_bool check_transfer_schedule(isl_ctx *ctx, isl_ctx *ctx2)
+{
+	const char *str;
+	isl_schedule *schedule, *schedule2;
+	isl_union_map *map, *map2;
+	isl_bool equal;
+
+	str = "{ domain: \"[n] -> { S[i] : 0 <= i < n; T[i] : 0 <= i < n }\", "
+		"child: { context: \"[n] -> { [] : n >= 0 }\", "
+		"child: { mark: \"outer\", "
+		"child: { schedule: \"[{ S[i] -> [(floor(i/2))]; "
+		"T[i] -> [(i)] }]\", coincident: [ 1 ], "
+		"child: { sequence: [ { filter: \"{ S[i] }\" }, "
+		"{ filter: \"{ T[i] }\" } ] } } } } }";
+	schedule = isl_schedule_read_from_str(ctx, str);
+	schedule2 = isl_schedule_transfer(isl_schedule_copy(schedule), ctx2);
+	if (schedule2 && isl_schedule_get_ctx(schedule2) != ctx2)
+		isl_die(ctx, isl_error_unknown, "object not transferred",
+			schedule2 = isl_schedule_free(schedule2));
+	map2 = isl_schedule_get_map(schedule2);
+	map2 = isl_union_map_transfer(map2, ctx);
+	schedule2 = isl_schedule_transfer(schedule2, ctx);
+	equal = isl_schedule_plain_is_equal(schedule, schedule2);
+	map = isl_schedule_get_map(schedule);
+	if (equal >= 0 && equal)
+		equal = isl_union_map_is_equal(map, map2);
+	isl_union_map_free(map);
+	isl_union_map_free(map2);
+	isl_schedule_free(schedule);
+	isl_schedule_free(schedule2);
+
+	return equal;
+}
+
+static int test_transfer(isl_ctx *ctx)
+{
+	const char *str;
+	isl_ctx *ctx2;
+	isl_union_map *umap, *umap2;
+	isl_aff *aff, *aff2;
+	isl_bool equal;
+
+	ctx2 = isl_ctx_alloc();
+	if (!ctx2)
+		return -1;
+
+	str = "[n] -> { A[i] -> B[[i] -> C[j]] : 0 <= i < n and j = i + 1; "
+		"A[i] -> [i + 2] : exists (a : i = 2a) }";
+	umap = isl_union_map_read_from_str(ctx, str);
+	umap2 = isl_union_map_transfer(isl_union_map_copy(umap), ctx2);
+	if (umap2 && isl_union_map_get_ctx(umap2) != ctx2)
+		isl_die(ctx, isl_error_unknown, "object not transferred",
+			umap2 = isl_union_map_free(umap2));
+	umap2 = isl_union_map_transfer(umap2, ctx);
+	equal = isl_union_map_is_equal(umap, umap2);
+	isl_union_map_free(umap);
+	isl_union_map_free(umap2);
+
+	if (equal >= 0 && !equal)
+		isl_die(ctx, isl_error_unknown, "unexpected result",
+			equal = isl_bool_error);
+
+	if (equal >= 0) {
+		str = "[n] -> { A[i] -> [(floor((i + n)/3) + 2)] }";
+		aff = isl_aff_read_from_str(ctx, str);
+		aff2 = isl_aff_transfer(isl_aff_copy(aff), ctx2);
+		aff2 = isl_aff_transfer(aff2, ctx);
+		equal = isl_aff_plain_is_equal(aff, aff2);
+		isl_aff_free(aff);
+		isl_aff_free(aff2);
+	}
+	if (equal >= 0 && equal)
+		equal = check_transfer_mupa(ctx, ctx2);
+	if (equal >= 0 && equal)
+		equal = check_transfer_schedule(ctx, ctx2);
+
+	isl_ctx_free(ctx2);
+
+	if (equal < 0)
+		return -1;
+	if (!equal)
+		isl_die(ctx, isl_error_unknown, "unexpected result", return -1);
+
+	return 0;
+}
+
 struct {
 	const char *name;
 	int (*fn)(isl_ctx *ctx);
 } tests [] = {
+	{ "AST expression cache", &test_ast_expr_cache },
+	{ "flow update", &test_flow_update },
+	{ "flow lexmax cache", &test_flow_lexmax_cache },
+	{ "LP session", &test_lp_session },
+	{ "schedule budget", &test_schedule_budget },
+	{ "schedule trace", &test_schedule_trace },
+	{ "schedule budget fallback", &test_schedule_budget_fallback },
+	{ "schedule update", &test_schedule_update },
+	{ "schedule update proximity", &test_schedule_update_proximity },
+	{ "coefficients cache", &test_coefficients_cache },
+	{ "sample cache", &test_sample_cache },
+	{ "statistics", &test_stats },
+	{ "transfer", &test_transfer },
 	{ "universe", &test_universe },
 	{ "domain hash", &test_domain_hash },
 	{ "dual", &test_dual },
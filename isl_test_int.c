@@ -57,6 +57,10 @@ struct {
 	{ &int_test_hash, "-2147483647" },
 	{ &int_test_hash, "2147483648" },
 	{ &int_test_hash, "-2147483648" },
+	{ &int_test_hash, "4611686018427387903" },
+	{ &int_test_hash, "-4611686018427387903" },
+	{ &int_test_hash, "4611686018427387904" },
+	{ &int_test_hash, "-4611686018427387904" },
 };
 
 static void int_test_single_value()
@@ -219,6 +223,8 @@ struct {
 	{ &int_test_neg, "-1", "1" },
 	{ &int_test_neg, "-2147483647", "2147483647" },
 	{ &int_test_neg, "-2147483648", "2147483648" },
+	{ &int_test_neg, "-4611686018427387903", "4611686018427387903" },
+	{ &int_test_neg, "-4611686018427387904", "4611686018427387904" },
 	{ &int_test_neg, "-9223372036854775807", "9223372036854775807" },
 	{ &int_test_neg, "-9223372036854775808", "9223372036854775808" },
 
@@ -227,6 +233,7 @@ struct {
 	{ &int_test_abs, "1", "-1" },
 	{ &int_test_abs, "2147483647", "2147483647" },
 	{ &int_test_abs, "2147483648", "-2147483648" },
+	{ &int_test_abs, "4611686018427387904", "-4611686018427387904" },
 	{ &int_test_abs, "9223372036854775807", "9223372036854775807" },
 	{ &int_test_abs, "9223372036854775808", "-9223372036854775808" },
 };
@@ -482,6 +489,16 @@ struct {
 	{ &int_test_sum, "2147483648", "2147483647", "1" },
 	{ &int_test_sum, "-2147483648", "-2147483647", "-1" },
 
+	{ &int_test_sum, "4611686018427387904",
+	  "2305843009213693952", "2305843009213693952" },
+	{ &int_test_sum, "-4611686018427387904",
+	  "-2305843009213693952", "-2305843009213693952" },
+	{ &int_test_sum, "9223372036854775808",
+	  "4611686018427387904", "4611686018427387904" },
+	{ &int_test_sum, "-9223372036854775808",
+	  "-4611686018427387904", "-4611686018427387904" },
+	{ &int_test_sum, "1", "4611686018427387904", "-4611686018427387903" },
+
 	{ &int_test_product, "0", "0", "0" },
 	{ &int_test_product, "0", "0", "1" },
 	{ &int_test_product, "1", "1", "1" },
@@ -508,6 +525,15 @@ struct {
 	{ &int_test_product,
 	  "4611686016279904256", "-2147483647", "-2147483648" },
 
+	{ &int_test_product,
+	  "4611686018427387904", "2147483648", "2147483648" },
+	{ &int_test_product,
+	  "-4611686018427387904", "-2147483648", "2147483648" },
+	{ &int_test_product,
+	  "9223372036854775808", "4294967296", "2147483648" },
+	{ &int_test_product,
+	  "-9223372036854775808", "4294967296", "-2147483648" },
+
 	{ &int_test_product, "85070591730234615847396907784232501249",
 	  "9223372036854775807", "9223372036854775807" },
 	{ &int_test_product, "-85070591730234615847396907784232501249",
@@ -545,6 +571,10 @@ struct {
 	{ &int_test_fdiv, "0", "-1", "-2" },
 	{ &int_test_fdiv_r, "-1", "-1", "-3" },
 
+	{ &int_test_fdiv, "-3", "-4611686018427387905", "2305843009213693952" },
+	{ &int_test_fdiv_r, "2305843009213693951",
+	  "-4611686018427387905", "2305843009213693952" },
+
 	{ &int_test_cdiv, "1", "1", "2" },
 	{ &int_test_cdiv, "0", "-1", "2" },
 	{ &int_test_cdiv, "0", "1", "-2" },
@@ -555,6 +585,9 @@ struct {
 	{ &int_test_tdiv, "0", "1", "-2" },
 	{ &int_test_tdiv, "0", "-1", "-2" },
 
+	{ &int_test_cdiv, "-2", "-4611686018427387905", "2305843009213693952" },
+	{ &int_test_tdiv, "-2", "-4611686018427387905", "2305843009213693952" },
+
 	{ &int_test_gcd, "0", "0", "0" },
 	{ &int_test_lcm, "0", "0", "0" },
 	{ &int_test_gcd, "7", "0", "7" },
@@ -571,6 +604,9 @@ struct {
 	{ &int_test_lcm, "15032385529", "7", "2147483647" },
 	{ &int_test_gcd, "2", "6", "-2147483648" },
 	{ &int_test_lcm, "6442450944", "6", "-2147483648" },
+	{ &int_test_gcd, "2147483648", "4611686018427387904", "6442450944" },
+	{ &int_test_lcm, "13835058055282163712",
+	  "4611686018427387904", "6442450944" },
 	{ &int_test_gcd, "1", "6", "9223372036854775807" },
 	{ &int_test_lcm, "55340232221128654842", "6", "9223372036854775807" },
 	{ &int_test_gcd, "2", "6", "-9223372036854775808" },
@@ -592,6 +628,8 @@ struct {
 	{ &int_test_abs_cmp, "-1", "5", "2147483647" },
 	{ &int_test_cmps, "1", "5", "-2147483648" },
 	{ &int_test_abs_cmp, "-1", "5", "-2147483648" },
+	{ &int_test_cmps, "1", "4611686018427387904", "4611686018427387903" },
+	{ &int_test_abs_cmp, "1", "-4611686018427387904", "4611686018427387903" },
 	{ &int_test_cmps, "-1", "5", "9223372036854775807" },
 	{ &int_test_abs_cmp, "-1", "5", "9223372036854775807" },
 	{ &int_test_cmps, "1", "5", "-9223372036854775809" },
@@ -303,6 +303,54 @@ __isl_give isl_union_set *isl_union_set_copy(__isl_keep isl_union_set *uset)
 	return isl_union_map_copy(uset);
 }
 
+/* isl_union_map_foreach_map callback for transferring "map"
+ * to the context of the union map pointed to by "user" and
+ * adding it to that union map.
+ */
+static isl_stat add_transferred(__isl_take isl_map *map, void *user)
+{
+	isl_union_map **res = user;
+	isl_ctx *ctx;
+
+	ctx = isl_union_map_get_ctx(*res);
+	map = isl_map_transfer(map, ctx);
+	*res = isl_union_map_add_map(*res, map);
+
+	return *res ? isl_stat_ok : isl_stat_error;
+}
+
+/* Return a copy of "umap" in "ctx".
+ */
+__isl_give isl_union_map *isl_union_map_transfer(
+	__isl_take isl_union_map *umap, isl_ctx *ctx)
+{
+	isl_space *space;
+	isl_union_map *res;
+
+	if (!umap || !ctx)
+		goto error;
+	if (isl_union_map_get_ctx(umap) == ctx)
+		return umap;
+
+	space = isl_space_transfer(isl_union_map_get_space(umap), ctx);
+	res = isl_union_map_empty(space);
+	if (isl_union_map_foreach_map(umap, &add_transferred, &res) < 0)
+		res = isl_union_map_free(res);
+	isl_union_map_free(umap);
+	return res;
+error:
+	isl_union_map_free(umap);
+	return NULL;
+}
+
+/* Return a copy of "uset" in "ctx".
+ */
+__isl_give isl_union_set *isl_union_set_transfer(
+	__isl_take isl_union_set *uset, isl_ctx *ctx)
+{
+	return isl_union_map_transfer(uset, ctx);
+}
+
 __isl_null isl_union_map *isl_union_map_free(__isl_take isl_union_map *umap)
 {
 	if (!umap)
@@ -1217,6 +1265,143 @@ __isl_give isl_union_map *isl_union_map_intersect_range(
 	return gen_bin_op(umap, uset, &intersect_range_entry);
 }
 
+/* A map in the hash table of an isl_union_map along with
+ * the set with which its range should be intersected.
+ * "pos" is the position of the map in the hash table.
+ */
+struct isl_union_map_range_match {
+	int pos;
+	isl_map *map;
+	isl_set *set;
+};
+
+/* Internal data structure for isl_union_map_intersect_range_domain_space.
+ *
+ * "umap" is the union map of which the range is being intersected.
+ * "domain" is the shared domain space of the maps in "umap".
+ * "match" collects the "n" maps of "umap" that have a range space
+ * that appears in the union set.
+ */
+struct isl_union_map_range_match_data {
+	isl_union_map *umap;
+	isl_space *domain;
+	int n;
+	struct isl_union_map_range_match *match;
+};
+
+/* Look for the map in data->umap with range space equal to the space
+ * of the set "entry" and record it in data->match if it exists.
+ */
+static isl_stat find_range_match(void **entry, void *user)
+{
+	struct isl_union_map_range_match_data *data = user;
+	isl_set *set = *entry;
+	isl_space *space;
+	uint32_t hash;
+	struct isl_hash_table_entry *entry2;
+
+	space = isl_space_map_from_domain_and_range(
+			isl_space_copy(data->domain), isl_set_get_space(set));
+	if (!space)
+		return isl_stat_error;
+	hash = isl_space_get_hash(space);
+	entry2 = isl_hash_table_find(data->umap->dim->ctx, &data->umap->table,
+				     hash, &has_dim, space, 0);
+	isl_space_free(space);
+	if (!entry2)
+		return isl_stat_ok;
+
+	data->match[data->n].pos = entry2 - data->umap->table.entries;
+	data->match[data->n].map = entry2->data;
+	data->match[data->n].set = set;
+	data->n++;
+
+	return isl_stat_ok;
+}
+
+/* Compare the positions of two isl_union_map_range_match structs.
+ */
+static int cmp_range_match(const void *p1, const void *p2)
+{
+	const struct isl_union_map_range_match *m1 = p1;
+	const struct isl_union_map_range_match *m2 = p2;
+
+	return m1->pos - m2->pos;
+}
+
+/* Intersect the range of "umap" with "uset", given that
+ * all maps in "umap" have a domain living in the space "domain".
+ * The parameters of "domain" are ignored.
+ *
+ * The result is the same as that of isl_union_map_intersect_range,
+ * including the order in which the maps are stored,
+ * but the maps that need to be intersected are looked up
+ * based on the sets in "uset" rather than the other way around.
+ * This is more efficient if "uset" contains far fewer sets
+ * than "umap" contains maps.
+ * In order to obtain the same order, the matching maps are
+ * added to the result in the order in which they appear in "umap".
+ */
+__isl_give isl_union_map *isl_union_map_intersect_range_domain_space(
+	__isl_take isl_union_map *umap, __isl_take isl_union_set *uset,
+	__isl_take isl_space *domain)
+{
+	int i;
+	isl_ctx *ctx;
+	isl_union_map *res;
+	struct isl_union_map_range_match_data data = { NULL };
+
+	umap = isl_union_map_align_params(umap, isl_union_set_get_space(uset));
+	uset = isl_union_set_align_params(uset, isl_union_map_get_space(umap));
+	domain = isl_space_drop_dims(domain, isl_dim_param,
+				0, isl_space_dim(domain, isl_dim_param));
+	domain = isl_space_align_params(domain, isl_union_map_get_space(umap));
+	if (!umap || !uset || !domain)
+		goto error;
+
+	ctx = isl_union_map_get_ctx(umap);
+	data.umap = umap;
+	data.domain = domain;
+	data.match = isl_alloc_array(ctx, struct isl_union_map_range_match,
+					uset->table.n);
+	if (uset->table.n && !data.match)
+		goto error;
+	if (isl_hash_table_foreach(ctx, &uset->table,
+				   &find_range_match, &data) < 0)
+		goto error;
+	qsort(data.match, data.n, sizeof(data.match[0]), &cmp_range_match);
+
+	res = isl_union_map_alloc(isl_union_map_get_space(umap), umap->table.n);
+	for (i = 0; res && i < data.n; ++i) {
+		isl_map *map;
+		isl_bool empty;
+
+		map = isl_map_copy(data.match[i].map);
+		map = isl_map_intersect_range(map,
+					isl_set_copy(data.match[i].set));
+		empty = isl_map_is_empty(map);
+		if (empty < 0 || empty) {
+			isl_map_free(map);
+			if (empty < 0)
+				res = isl_union_map_free(res);
+			continue;
+		}
+		res = isl_union_map_add_map(res, map);
+	}
+
+	free(data.match);
+	isl_space_free(domain);
+	isl_union_map_free(umap);
+	isl_union_set_free(uset);
+	return res;
+error:
+	free(data.match);
+	isl_space_free(domain);
+	isl_union_map_free(umap);
+	isl_union_set_free(uset);
+	return NULL;
+}
+
 struct isl_union_map_bin_data {
 	isl_union_map *umap2;
 	isl_union_map *res;
@@ -1621,14 +1806,36 @@ __isl_give isl_union_set *isl_union_set_simple_hull(
 	return isl_union_map_simple_hull(uset);
 }
 
+/* Internal data structure for inplace.
+ * "fn" is the function that is applied to each of the maps.
+ * "keep" is set if the original maps need to be kept in the table
+ * in case "fn" fails, because the union map is also referenced elsewhere.
+ */
+struct isl_union_map_inplace_data {
+	__isl_give isl_map *(*fn)(__isl_take isl_map *);
+	int keep;
+};
+
+/* Replace the map in "entry" by the result of applying data->fn to it.
+ *
+ * If the original map does not need to be kept in case of failure,
+ * then it is passed to data->fn directly, such that data->fn
+ * can modify it in place if it is not referenced anywhere else.
+ * Otherwise, data->fn is applied to a copy, which means that
+ * any modification of the map first requires a duplicate to be created.
+ */
 static isl_stat inplace_entry(void **entry, void *user)
 {
-	__isl_give isl_map *(*fn)(__isl_take isl_map *);
+	struct isl_union_map_inplace_data *data = user;
 	isl_map **map = (isl_map **)entry;
 	isl_map *copy;
 
-	fn = *(__isl_give isl_map *(**)(__isl_take isl_map *)) user;
-	copy = fn(isl_map_copy(*map));
+	if (!data->keep) {
+		*map = data->fn(*map);
+		return *map ? isl_stat_ok : isl_stat_error;
+	}
+
+	copy = data->fn(isl_map_copy(*map));
 	if (!copy)
 		return isl_stat_error;
 
@@ -1638,14 +1845,25 @@ static isl_stat inplace_entry(void **entry, void *user)
 	return isl_stat_ok;
 }
 
+/* Apply "fn" to each of the maps in "umap", assuming the result
+ * has the same meaning and space as the original map.
+ * The maps can therefore be replaced in the table of "umap",
+ * even if "umap" is also referenced elsewhere.
+ * In the latter case, the maps in the table are only replaced
+ * if "fn" succeeds.  If "umap" is not referenced anywhere else,
+ * then "umap" is destroyed anyway in case of failure.
+ */
 static __isl_give isl_union_map *inplace(__isl_take isl_union_map *umap,
 	__isl_give isl_map *(*fn)(__isl_take isl_map *))
 {
+	struct isl_union_map_inplace_data data = { fn };
+
 	if (!umap)
 		return NULL;
 
+	data.keep = umap->ref != 1;
 	if (isl_hash_table_foreach(umap->dim->ctx, &umap->table,
-				    &inplace_entry, &fn) < 0)
+				    &inplace_entry, &data) < 0)
 		goto error;
 
 	return umap;
@@ -1,5 +1,6 @@
 #define isl_union_set_list	isl_union_map_list
 #define isl_union_set	isl_union_map
+#include <isl/hash.h>
 #include <isl/union_map.h>
 #include <isl/union_set.h>
 
@@ -12,3 +13,6 @@ struct isl_union_map {
 
 __isl_give isl_union_map *isl_union_map_reset_range_space(
 	__isl_take isl_union_map *umap, __isl_take isl_space *space);
+__isl_give isl_union_map *isl_union_map_intersect_range_domain_space(
+	__isl_take isl_union_map *umap, __isl_take isl_union_set *uset,
+	__isl_take isl_space *domain);
@@ -301,6 +301,35 @@ static __isl_give UNION *FN(UNION,transform)(__isl_take UNION *u,
 	return FN(UNION,transform_space)(u, FN(UNION,get_space)(u), fn, user);
 }
 
+#ifndef NO_TRANSFER
+/* Return a copy of "part" in the isl_ctx "user".
+ */
+static __isl_give PART *FN(UNION,transfer_entry)(__isl_take PART *part,
+	void *user)
+{
+	return FN(PART,transfer)(part, user);
+}
+
+/* Return a copy of "u" in "ctx".
+ */
+__isl_give UNION *FN(UNION,transfer)(__isl_take UNION *u, isl_ctx *ctx)
+{
+	isl_space *space;
+
+	if (!u || !ctx)
+		goto error;
+	if (FN(UNION,get_ctx)(u) == ctx)
+		return u;
+
+	space = isl_space_transfer(FN(UNION,get_space)(u), ctx);
+	return FN(UNION,transform_space)(u, space,
+					&FN(UNION,transfer_entry), ctx);
+error:
+	FN(UNION,free)(u);
+	return NULL;
+}
+#endif
+
 /* Apply data->fn to *part and store the result back into *part.
  */
 static isl_stat FN(UNION,transform_inplace_entry)(void **part, void *user)
@@ -785,15 +814,24 @@ __isl_give UNION *FN(UNION,gist)(__isl_take UNION *u,
 	return FN(UNION,match_domain_op)(u, uset, &FN(PW,gist));
 }
 
-/* Coalesce an entry in a UNION.  Coalescing is performed in-place.
- * Since the UNION may have several references, the entry is only
- * replaced if the coalescing is successful.
+/* Coalesce the part in "entry" in-place.
+ * "user" points to a flag that is set if the UNION has several
+ * references.  In that case, the coalescing is performed on a copy
+ * and the entry is only replaced if the coalescing is successful.
+ * Otherwise, the part is coalesced directly, allowing it
+ * to be modified in place.
  */
 static isl_stat FN(UNION,coalesce_entry)(void **entry, void *user)
 {
+	int *keep = user;
 	PART **part_p = (PART **) entry;
 	PART *part;
 
+	if (!*keep) {
+		*part_p = FN(PW,coalesce)(*part_p);
+		return *part_p ? isl_stat_ok : isl_stat_error;
+	}
+
 	part = FN(PART,copy)(*part_p);
 	part = FN(PW,coalesce)(part);
 	if (!part)
@@ -806,7 +844,13 @@ static isl_stat FN(UNION,coalesce_entry)(void **entry, void *user)
 
 __isl_give UNION *FN(UNION,coalesce)(__isl_take UNION *u)
 {
-	if (FN(UNION,foreach_inplace)(u, &FN(UNION,coalesce_entry), NULL) < 0)
+	int keep;
+
+	if (!u)
+		return NULL;
+
+	keep = u->ref != 1;
+	if (FN(UNION,foreach_inplace)(u, &FN(UNION,coalesce_entry), &keep) < 0)
 		goto error;
 
 	return u;
@@ -243,6 +243,29 @@ __isl_give isl_val *isl_val_dup(__isl_keep isl_val *val)
 	return dup;
 }
 
+/* Return a copy of "val" in "ctx".
+ */
+__isl_give isl_val *isl_val_transfer(__isl_take isl_val *val, isl_ctx *ctx)
+{
+	isl_val *dup;
+
+	if (!val || !ctx)
+		goto error;
+	if (val->ctx == ctx)
+		return val;
+
+	dup = isl_val_alloc(ctx);
+	if (dup) {
+		isl_int_set(dup->n, val->n);
+		isl_int_set(dup->d, val->d);
+	}
+	isl_val_free(val);
+	return dup;
+error:
+	isl_val_free(val);
+	return NULL;
+}
+
 /* Return an isl_val that is equal to "val" and that has only
  * a single reference.
  */
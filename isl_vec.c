@@ -204,6 +204,27 @@ struct isl_vec *isl_vec_dup(struct isl_vec *vec)
 	return vec2;
 }
 
+/* Return a copy of "vec" in "ctx".
+ */
+__isl_give isl_vec *isl_vec_transfer(__isl_take isl_vec *vec, isl_ctx *ctx)
+{
+	isl_vec *dup;
+
+	if (!vec || !ctx)
+		goto error;
+	if (vec->ctx == ctx)
+		return vec;
+
+	dup = isl_vec_alloc(ctx, vec->size);
+	if (dup)
+		isl_seq_cpy(dup->el, vec->el, vec->size);
+	isl_vec_free(vec);
+	return dup;
+error:
+	isl_vec_free(vec);
+	return NULL;
+}
+
 struct isl_vec *isl_vec_cow(struct isl_vec *vec)
 {
 	struct isl_vec *vec2;
@@ -0,0 +1,119 @@
+/*
+ * Use of this software is governed by the MIT license
+ */
+
+/* This program takes an isl_schedule_constraints object as input,
+ * computes a schedule that satisfies those constraints and
+ * prints a YAML mapping in flow style (which is also valid JSON)
+ * describing the cost of this computation.
+ * In particular, the mapping contains the processor time
+ * (in microseconds) of a single computation, averaged over
+ * the number of repetitions, the peak memory usage of the process
+ * (in kilobytes) and the statistics collected by the isl_ctx
+ * during the last computation.
+ * The schedule itself is not printed.
+ */
+
+#include <stdio.h>
+#include <time.h>
+#include <sys/resource.h>
+#include <isl/ctx.h>
+#include <isl/options.h>
+#include <isl/printer.h>
+#include <isl/schedule.h>
+
+struct options {
+	struct isl_options	*isl;
+	int			 repeat;
+};
+
+ISL_ARGS_START(struct options, options_args)
+ISL_ARG_CHILD(struct options, isl, "isl", &isl_options_args, "isl options")
+ISL_ARG_INT(struct options, repeat, 0, "repeat", "n", 1,
+	"number of times the schedule is computed")
+ISL_ARGS_END
+
+ISL_ARG_DEF(bench_options, struct options, options_args)
+
+/* Print the key "key" of an element in a YAML mapping in flow style,
+ * quoted such that the mapping is also valid JSON.
+ * If "first" is not set, then move to the next element first.
+ */
+static __isl_give isl_printer *print_key(__isl_take isl_printer *p,
+	const char *key, int first)
+{
+	if (!first)
+		p = isl_printer_yaml_next(p);
+	p = isl_printer_print_str(p, "\"");
+	p = isl_printer_print_str(p, key);
+	p = isl_printer_print_str(p, "\"");
+	p = isl_printer_yaml_next(p);
+
+	return p;
+}
+
+/* Print the key "key" and the value "v" of an element in a YAML mapping.
+ */
+static __isl_give isl_printer *print_long(__isl_take isl_printer *p,
+	const char *key, long v, int first)
+{
+	char buffer[50];
+
+	p = print_key(p, key, first);
+	snprintf(buffer, sizeof(buffer), "%ld", v);
+	p = isl_printer_print_str(p, buffer);
+
+	return p;
+}
+
+int main(int argc, char **argv)
+{
+	int i;
+	int r = 0;
+	isl_ctx *ctx;
+	isl_printer *p;
+	isl_schedule_constraints *sc;
+	isl_schedule *schedule;
+	struct options *options;
+	struct rusage usage;
+	clock_t start;
+	double time;
+
+	options = bench_options_new_with_defaults();
+	ctx = isl_ctx_alloc_with_options(&options_args, options);
+	argc = bench_options_parse(options, argc, argv, ISL_ARG_ALL);
+
+	sc = isl_schedule_constraints_read_from_file(ctx, stdin);
+	if (options->repeat < 1)
+		options->repeat = 1;
+
+	start = clock();
+	for (i = 0; i < options->repeat; ++i) {
+		isl_ctx_reset_stats(ctx);
+		schedule = isl_schedule_constraints_compute_schedule(
+					isl_schedule_constraints_copy(sc));
+		if (!schedule)
+			r = 1;
+		isl_schedule_free(schedule);
+	}
+	time = (double) (clock() - start) * 1000000 / CLOCKS_PER_SEC;
+	isl_schedule_constraints_free(sc);
+	if (getrusage(RUSAGE_SELF, &usage) < 0)
+		usage.ru_maxrss = -1;
+
+	p = isl_printer_to_file(ctx, stdout);
+	p = isl_printer_set_yaml_style(p, ISL_YAML_STYLE_FLOW);
+	p = isl_printer_yaml_start_mapping(p);
+	p = print_long(p, "time_us", (long) (time / options->repeat), 1);
+	p = print_long(p, "max_rss_kb", usage.ru_maxrss, 0);
+	p = print_long(p, "failed", r, 0);
+	p = print_key(p, "stats", 0);
+	p = isl_printer_print_stats(p, isl_ctx_get_stats(ctx));
+	p = isl_printer_yaml_end_mapping(p);
+	p = isl_printer_end_line(p);
+	isl_printer_free(p);
+
+	isl_ctx_free(ctx);
+
+	return r;
+}
@@ -0,0 +1,4 @@
+# tmp = A * B; D = beta * D + tmp * C
+domain: "[N] -> { S0[i, j] : 0 <= i, j < N; S1[i, j, k] : 0 <= i, j, k < N; S2[i, j] : 0 <= i, j < N; S3[i, j, k] : 0 <= i, j, k < N }"
+validity: "[N] -> { S0[i, j] -> S1[i, j, 0] : 0 <= i, j < N; S1[i, j, k] -> S1[i, j, 1 + k] : 0 <= i, j < N and 0 <= k < N - 1; S1[i, k, N - 1] -> S3[i, j, k] : 0 <= i, j, k < N; S2[i, j] -> S3[i, j, 0] : 0 <= i, j < N; S3[i, j, k] -> S3[i, j, 1 + k] : 0 <= i, j < N and 0 <= k < N - 1 }"
+proximity: "[N] -> { S0[i, j] -> S1[i, j, 0] : 0 <= i, j < N; S1[i, j, k] -> S1[i, j, 1 + k] : 0 <= i, j < N and 0 <= k < N - 1; S1[i, k, N - 1] -> S3[i, j, k] : 0 <= i, j, k < N; S2[i, j] -> S3[i, j, 0] : 0 <= i, j < N; S3[i, j, k] -> S3[i, j, 1 + k] : 0 <= i, j < N and 0 <= k < N - 1 }"
@@ -0,0 +1,5 @@
+# C = A * B
+domain: "[N] -> { S0[i, j] : 0 <= i, j < N; S1[i, j, k] : 0 <= i, j, k < N }"
+validity: "[N] -> { S0[i, j] -> S1[i, j, 0] : 0 <= i, j < N; S1[i, j, k] -> S1[i, j, 1 + k] : 0 <= i, j < N and 0 <= k < N - 1 }"
+coincidence: "[N] -> { S0[i, j] -> S1[i, j, 0] : 0 <= i, j < N; S1[i, j, k] -> S1[i, j, 1 + k] : 0 <= i, j < N and 0 <= k < N - 1 }"
+proximity: "[N] -> { S0[i, j] -> S1[i, j, 0] : 0 <= i, j < N; S1[i, j, k] -> S1[i, j, 1 + k] : 0 <= i, j < N and 0 <= k < N - 1 }"
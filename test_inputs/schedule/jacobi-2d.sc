@@ -0,0 +1,4 @@
+# for t: B = stencil(A) on the interior; A = B
+domain: "[T, N] -> { S0[t, i, j] : 0 <= t < T and 1 <= i, j < N - 1; S1[t, i, j] : 0 <= t < T and 1 <= i, j < N - 1 }"
+validity: "[T, N] -> { S0[t, i, j] -> S1[t, i, j]; S1[t, i, j] -> S0[1 + t, i', j'] : -1 <= i' - i <= 1 and -1 <= j' - j <= 1 and (i' = i or j' = j); S0[t, i, j] -> S1[t, i', j'] : -1 <= i' - i <= 1 and -1 <= j' - j <= 1 and (i' = i or j' = j) }"
+proximity: "[T, N] -> { S0[t, i, j] -> S1[t, i, j]; S1[t, i, j] -> S0[1 + t, i', j'] : -1 <= i' - i <= 1 and -1 <= j' - j <= 1 and (i' = i or j' = j); S0[t, i, j] -> S1[t, i', j'] : -1 <= i' - i <= 1 and -1 <= j' - j <= 1 and (i' = i or j' = j) }"
@@ -0,0 +1,4 @@
+# for k: A[k][j] /= A[k][k] (j > k); A[i][j] -= A[i][k] * A[k][j] (i, j > k)
+domain: "[N] -> { S0[k, j] : 0 <= k < j < N; S1[k, i, j] : 0 <= k < i < N and k < j < N }"
+validity: "[N] -> { S0[k, j] -> S1[k, i, j] : k < i < N; S1[k, i, j] -> S1[1 + k, i, j] : i > 1 + k and j > 1 + k; S1[k, 1 + k, j] -> S0[1 + k, j] : j > 1 + k; S1[k, 1 + k, 1 + k] -> S0[1 + k, j] : 1 + k < j < N; S1[k, i, 1 + k] -> S1[1 + k, i, j] : i > 1 + k and 1 + k < j < N }"
+proximity: "[N] -> { S0[k, j] -> S1[k, i, j] : k < i < N; S1[k, i, j] -> S1[1 + k, i, j] : i > 1 + k and j > 1 + k; S1[k, 1 + k, j] -> S0[1 + k, j] : j > 1 + k; S1[k, 1 + k, 1 + k] -> S0[1 + k, j] : 1 + k < j < N; S1[k, i, 1 + k] -> S1[1 + k, i, j] : i > 1 + k and 1 + k < j < N }"
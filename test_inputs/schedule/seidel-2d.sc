@@ -0,0 +1,4 @@
+# for t: A[i][j] = average of the 3x3 neighborhood of A[i][j] (in place)
+domain: "[T, N] -> { S[t, i, j] : 0 <= t < T and 1 <= i, j < N - 1 }"
+validity: "[T, N] -> { S[t, i, j] -> S[t, i, 1 + j]; S[t, i, j] -> S[t, 1 + i, j'] : -1 <= j' - j <= 1; S[t, i, j] -> S[1 + t, i', j'] : -1 <= i' - i <= 1 and -1 <= j' - j <= 1 }"
+proximity: "[T, N] -> { S[t, i, j] -> S[t, i, 1 + j]; S[t, i, j] -> S[t, 1 + i, j'] : -1 <= j' - j <= 1; S[t, i, j] -> S[1 + t, i', j'] : -1 <= i' - i <= 1 and -1 <= j' - j <= 1 }"